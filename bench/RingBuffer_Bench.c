@@ -0,0 +1,517 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Bench.c
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Ring buffer throughput / latency benchmark.
+ *
+ * Usage: RingBuffer_Bench [items] [producers] [consumers]
+ *
+ * One JSON object per line is printed for each measurement, so that results can be diffed across versions:
+ * - single-thread Push/Pop and Fill/Empty throughput for element sizes from 1 B to 1 KiB;
+ * - 1:1 and N:M (producers:consumers) throughput of 64 B messages, producers flooding the ring;
+ * - 1:1 round-trip latency percentiles of 64 B messages bounced through two rings (ping-pong): a single message is in
+ *   flight, hence queueing time is not measured.
+ * Threaded layouts need thread-safe operations, hence they only run if \ref RING_BUFFER_PROTECT (N:M and 1:1) or
+ * \ref RING_BUFFER_SPSC (1:1) is enabled.
+ */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/**
+ * Ring buffer length used by every measurement.
+ */
+#define RING_BUFFER_BENCH_LENGTH 1024
+
+/**
+ * Number of items moved by each Fill / Empty call.
+ */
+#define RING_BUFFER_BENCH_BATCH 64
+
+/**
+ * Maximum number of producer / consumer threads.
+ */
+#define RING_BUFFER_BENCH_THREADS 64
+
+/**
+ * Number of failed attempts before a waiting thread yields the CPU.
+ */
+#define RING_BUFFER_BENCH_SPIN 1024U
+
+/**
+ * Configuration name reported in results.
+ */
+#if (RING_BUFFER_PROTECT == 1)
+    #define RING_BUFFER_BENCH_CONFIG "protect"
+#elif (RING_BUFFER_SPSC == 1)
+    #define RING_BUFFER_BENCH_CONFIG "spsc"
+#else
+    #define RING_BUFFER_BENCH_CONFIG "none"
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+/**
+ * Element sizes in bytes (X-macro).
+ */
+#define RingBuffer_BenchSizes(pX) \
+    pX (1)                        \
+    pX (8)                        \
+    pX (64)                       \
+    pX (256)                      \
+    pX (1024)
+
+/**
+ * Defines element type, ring buffer and single-thread measurement of an element size.
+ *
+ * @param pSize Element size in bytes.
+ */
+#define RingBuffer_BenchDefine(pSize)                                                                     \
+    typedef struct                                                                                        \
+    {                                                                                                     \
+        uint8_t data[(pSize)];                                                                            \
+    } RingBuffer_BenchItem##pSize##_t;                                                                    \
+                                                                                                          \
+    RingBuffer_Create (static, RingBuffer_BenchItem##pSize##_t, benchRing##pSize,                         \
+                       RING_BUFFER_BENCH_LENGTH, RingBuffer_BenchProtect, &benchMutex);                   \
+                                                                                                          \
+    static RingBuffer_BenchItem##pSize##_t benchBatch##pSize[RING_BUFFER_BENCH_BATCH];                    \
+                                                                                                          \
+    static void                                                                                           \
+    RingBuffer_BenchSingle##pSize (uint32_t items)                                                        \
+    {                                                                                                     \
+        RingBuffer_BenchItem##pSize##_t item;                                                             \
+        uint32_t                        i;                                                                \
+        uint32_t                        j;                                                                \
+        uint64_t                        start;                                                            \
+                                                                                                          \
+        RingBuffer_Reset (benchRing##pSize);                                                              \
+        (void) memset (&item, 0x5A, sizeof (item));                                                       \
+        (void) memset (benchBatch##pSize, 0x5A, sizeof (benchBatch##pSize));                              \
+                                                                                                          \
+        start = RingBuffer_BenchNow ();                                                                   \
+        for (i = 0U; i < items; i += RING_BUFFER_BENCH_BATCH)                                             \
+        {                                                                                                 \
+            for (j = 0U; j < RING_BUFFER_BENCH_BATCH; j++)                                                \
+            {                                                                                             \
+                item.data[0] = (uint8_t) j;                                                               \
+                RingBuffer_Push (benchRing##pSize, item);                                                 \
+            }                                                                                             \
+            for (j = 0U; j < RING_BUFFER_BENCH_BATCH; j++)                                                \
+            {                                                                                             \
+                RingBuffer_Pop (benchRing##pSize, item);                                                  \
+                benchSink += item.data[0];                                                                \
+            }                                                                                             \
+        }                                                                                                 \
+        RingBuffer_BenchReport ("single", "push_pop", (pSize), items, (RingBuffer_BenchNow () - start),   \
+                                NULL, 0U);                                                                \
+                                                                                                          \
+        start = RingBuffer_BenchNow ();                                                                   \
+        for (i = 0U; i < items; i += RING_BUFFER_BENCH_BATCH)                                             \
+        {                                                                                                 \
+            RingBuffer_Fill (benchRing##pSize, benchBatch##pSize, RING_BUFFER_BENCH_BATCH);               \
+            RingBuffer_Empty (benchBatch##pSize, benchRing##pSize, RING_BUFFER_BENCH_BATCH);              \
+            benchSink += benchBatch##pSize[0].data[0];                                                    \
+        }                                                                                                 \
+        RingBuffer_BenchReport ("single", "fill_empty", (pSize), items, (RingBuffer_BenchNow () - start), \
+                                NULL, 0U);                                                                \
+    }
+
+/**
+ * Retries a non-blocking operation until it succeeds or the benchmark is stopped, yielding the CPU every
+ * \ref RING_BUFFER_BENCH_SPIN failed attempts.
+ *
+ * @param pOp     Operation (TryPush / TryPop).
+ * @param pStatus Status variable written by the operation.
+ */
+#define RingBuffer_BenchRetry(pOp, pStatus)                                                   \
+    do                                                                                        \
+    {                                                                                         \
+        uint32_t benchSpin = 0U;                                                              \
+                                                                                              \
+        pOp;                                                                                  \
+                                                                                              \
+        while (((pStatus) != RING_BUFFER_OK) && !RingBuffer_BenchStopped ())                  \
+        {                                                                                     \
+            if ((++benchSpin % RING_BUFFER_BENCH_SPIN) == 0U)                                 \
+            {                                                                                 \
+                (void) sched_yield ();                                                        \
+            }                                                                                 \
+            else                                                                              \
+            {                                                                                 \
+            }                                                                                 \
+                                                                                              \
+            pOp;                                                                              \
+        }                                                                                     \
+    } while (0)
+
+/**
+ * Runs single-thread measurement of an element size.
+ *
+ * @param pSize Element size in bytes.
+ */
+#define RingBuffer_BenchRunSingle(pSize) \
+    RingBuffer_BenchSingle##pSize (items);
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/**
+ * Message handed off between threads.
+ */
+typedef struct
+{
+    uint64_t stamp;    /**< Push time in ns (ping-pong) or sequence number. */
+    uint8_t  data[56]; /**< Payload. */
+} RingBuffer_BenchMessage_t;
+
+/**
+ * Thread arguments.
+ */
+typedef struct
+{
+    uint32_t items; /**< Number of messages to push / pop. */
+} RingBuffer_BenchThread_t;
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+static pthread_mutex_t benchMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static volatile uint32_t benchSink;
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+static void
+RingBuffer_BenchProtect (uint8_t op, void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for benchmark purpose
+    pthread_mutex_t* ptrMutex = ptrArg;
+
+    if (op == RING_BUFFER_LOCK)
+    {
+        (void) pthread_mutex_lock (ptrMutex);
+    }
+    else
+    {
+        (void) pthread_mutex_unlock (ptrMutex);
+    }
+}
+
+static uint64_t
+RingBuffer_BenchNow (void)
+{
+    struct timespec now;
+
+    (void) clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t) now.tv_sec * 1000000000U) + (uint64_t) now.tv_nsec;
+}
+
+static int
+RingBuffer_BenchCompare (const void* ptrA, const void* ptrB)
+{
+    uint32_t a = *(const uint32_t*) ptrA;
+    uint32_t b = *(const uint32_t*) ptrB;
+
+    return (a > b) - (a < b);
+}
+
+static void
+RingBuffer_BenchReport (const char* ptrLayout, const char* ptrOp, uint32_t size, uint32_t items, uint64_t ns,
+                        uint32_t* ptrLatency, uint32_t count)
+{
+    (void) printf ("{\"config\":\"%s\",\"pow2\":%d,\"cache_align\":%d,\"layout\":\"%s\",\"op\":\"%s\","
+                   "\"size\":%"PRIu32",\"items\":%"PRIu32",\"ns\":%"PRIu64",\"items_per_sec\":%.0f",
+                   RING_BUFFER_BENCH_CONFIG, RING_BUFFER_POW2, RING_BUFFER_CACHE_ALIGN, ptrLayout, ptrOp, size,
+                   items, ns, ((double) items * 1e9) / (double) ((ns != 0U) ? ns : 1U));
+
+    if (count != 0U)
+    {
+        qsort (ptrLatency, count, sizeof (uint32_t), RingBuffer_BenchCompare);
+
+        (void) printf (",\"p50_ns\":%"PRIu32",\"p99_ns\":%"PRIu32",\"p999_ns\":%"PRIu32,
+                       ptrLatency[((uint64_t) count * 500U) / 1000U],
+                       ptrLatency[((uint64_t) count * 990U) / 1000U],
+                       ptrLatency[((uint64_t) count * 999U) / 1000U]);
+    }
+    else
+    {
+    }
+
+    (void) printf ("}\n");
+}
+
+/* Single-thread measurements, one per element size. */
+RingBuffer_BenchSizes (RingBuffer_BenchDefine)
+
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+RingBuffer_Create (static, RingBuffer_BenchMessage_t, benchMessages, RING_BUFFER_BENCH_LENGTH,
+                   RingBuffer_BenchProtect, &benchMutex);
+
+RingBuffer_Create (static, RingBuffer_BenchMessage_t, benchPings, RING_BUFFER_BENCH_LENGTH,
+                   RingBuffer_BenchProtect, &benchMutex);
+
+RingBuffer_Create (static, RingBuffer_BenchMessage_t, benchPongs, RING_BUFFER_BENCH_LENGTH,
+                   RingBuffer_BenchProtect, &benchMutex);
+
+/** Set to release the running threads when a layout cannot be started. */
+static atomic_bool benchStop;
+
+static bool
+RingBuffer_BenchStopped (void)
+{
+    return atomic_load_explicit (&benchStop, memory_order_relaxed);
+}
+
+static void*
+RingBuffer_BenchProducer (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for benchmark purpose
+    RingBuffer_BenchThread_t* ptrThread = ptrArg;
+    RingBuffer_BenchMessage_t message;
+    uint32_t                  i;
+    int32_t                   status;
+
+    (void) memset (&message, 0x00, sizeof (message));
+
+    for (i = 0U; (i < ptrThread->items) && !RingBuffer_BenchStopped (); i++)
+    {
+        message.stamp = i;
+
+        RingBuffer_BenchRetry (RingBuffer_TryPush (benchMessages, message, status), status);
+    }
+
+    return NULL;
+}
+
+static void*
+RingBuffer_BenchConsumer (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for benchmark purpose
+    RingBuffer_BenchThread_t* ptrThread = ptrArg;
+    RingBuffer_BenchMessage_t message;
+    uint32_t                  i;
+    int32_t                   status;
+
+    for (i = 0U; (i < ptrThread->items) && !RingBuffer_BenchStopped (); i++)
+    {
+        RingBuffer_BenchRetry (RingBuffer_TryPop (benchMessages, message, status), status);
+    }
+
+    (void) message;
+
+    return NULL;
+}
+
+static void*
+RingBuffer_BenchEcho (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for benchmark purpose
+    RingBuffer_BenchThread_t* ptrThread = ptrArg;
+    RingBuffer_BenchMessage_t message;
+    uint32_t                  i;
+    int32_t                   status;
+
+    for (i = 0U; (i < ptrThread->items) && !RingBuffer_BenchStopped (); i++)
+    {
+        RingBuffer_BenchRetry (RingBuffer_TryPop (benchPings, message, status), status);
+        RingBuffer_BenchRetry (RingBuffer_TryPush (benchPongs, message, status), status);
+    }
+
+    return NULL;
+}
+
+static int
+RingBuffer_BenchThreads (uint32_t producers, uint32_t consumers, uint32_t items)
+{
+    pthread_t                threads[2U * RING_BUFFER_BENCH_THREADS];
+    RingBuffer_BenchThread_t args[2U * RING_BUFFER_BENCH_THREADS];
+    uint32_t                 started;
+    uint32_t                 i;
+    uint64_t                 start;
+    int                      status;
+    char                     layout[32];
+
+    /* Every thread moves the same number of messages. */
+    items   = (items / (producers * consumers)) * (producers * consumers);
+    started = 0U;
+    status  = 0;
+
+    RingBuffer_Reset (benchMessages);
+
+    (void) snprintf (layout, sizeof (layout), "%"PRIu32":%"PRIu32, producers, consumers);
+
+    start = RingBuffer_BenchNow ();
+
+    for (i = 0U; (i < (consumers + producers)) && (status == 0); i++)
+    {
+        if (i < consumers)
+        {
+            args[i].items = items / consumers;
+            status        = pthread_create (&threads[i], NULL, RingBuffer_BenchConsumer, &args[i]);
+        }
+        else
+        {
+            args[i].items = items / producers;
+            status        = pthread_create (&threads[i], NULL, RingBuffer_BenchProducer, &args[i]);
+        }
+
+        started += (status == 0) ? 1U : 0U;
+    }
+
+    if (status != 0)
+    {
+        /* Threads already started would wait forever for their peers. */
+        atomic_store_explicit (&benchStop, true, memory_order_relaxed);
+
+        (void) fprintf (stderr, "%s: pthread_create failed (%s)\n", layout, strerror (status));
+    }
+    else
+    {
+    }
+
+    for (i = 0U; i < started; i++)
+    {
+        (void) pthread_join (threads[i], NULL);
+    }
+
+    atomic_store_explicit (&benchStop, false, memory_order_relaxed);
+
+    if (status == 0)
+    {
+        RingBuffer_BenchReport (layout, "try_push_pop", (uint32_t) sizeof (RingBuffer_BenchMessage_t), items,
+                                (RingBuffer_BenchNow () - start), NULL, 0U);
+    }
+    else
+    {
+    }
+
+    return (status != 0) ? 1 : 0;
+}
+
+static int
+RingBuffer_BenchPingPong (uint32_t items)
+{
+    pthread_t                 thread;
+    RingBuffer_BenchThread_t  arg;
+    RingBuffer_BenchMessage_t message;
+    uint32_t*                 ptrLatency;
+    uint32_t                  i;
+    uint64_t                  start;
+    int32_t                   status;
+    int                       result;
+
+    ptrLatency = malloc ((size_t) items * sizeof (uint32_t));
+    result     = (ptrLatency != NULL) ? 0 : ENOMEM;
+
+    if (result == 0)
+    {
+        RingBuffer_Reset (benchPings);
+        RingBuffer_Reset (benchPongs);
+        (void) memset (&message, 0x00, sizeof (message));
+
+        arg.items = items;
+        result    = pthread_create (&thread, NULL, RingBuffer_BenchEcho, &arg);
+    }
+    else
+    {
+    }
+
+    if (result == 0)
+    {
+        start = RingBuffer_BenchNow ();
+
+        /* One message in flight at a time: the rings stay (nearly) empty and no queueing time is measured. */
+        for (i = 0U; i < items; i++)
+        {
+            message.stamp = RingBuffer_BenchNow ();
+
+            RingBuffer_BenchRetry (RingBuffer_TryPush (benchPings, message, status), status);
+            RingBuffer_BenchRetry (RingBuffer_TryPop (benchPongs, message, status), status);
+
+            ptrLatency[i] = (uint32_t) (RingBuffer_BenchNow () - message.stamp);
+        }
+
+        (void) pthread_join (thread, NULL);
+
+        RingBuffer_BenchReport ("1:1", "ping_pong", (uint32_t) sizeof (RingBuffer_BenchMessage_t), items,
+                                (RingBuffer_BenchNow () - start), ptrLatency, items);
+    }
+    else
+    {
+        (void) fprintf (stderr, "1:1: ping_pong setup failed (%s)\n", strerror (result));
+    }
+
+    free (ptrLatency);
+
+    return (result != 0) ? 1 : 0;
+}
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+
+int
+main (int argc, char** argv)
+{
+    uint32_t items;
+    uint32_t producers;
+    uint32_t consumers;
+    int      status;
+
+    items     = (argc > 1) ? (uint32_t) strtoul (argv[1], NULL, 0) : (1UL << 20);
+    producers = (argc > 2) ? (uint32_t) strtoul (argv[2], NULL, 0) : 2U;
+    consumers = (argc > 3) ? (uint32_t) strtoul (argv[3], NULL, 0) : 2U;
+
+    if ((producers == 0U) || (producers > RING_BUFFER_BENCH_THREADS) ||
+        (consumers == 0U) || (consumers > RING_BUFFER_BENCH_THREADS))
+    {
+        (void) fprintf (stderr, "usage: %s [items] [producers (1-%d)] [consumers (1-%d)]\n", argv[0],
+                        RING_BUFFER_BENCH_THREADS, RING_BUFFER_BENCH_THREADS);
+
+        return 1;
+    }
+    else
+    {
+    }
+
+    /* Whole batches only. */
+    items = ((items + RING_BUFFER_BENCH_BATCH - 1U) / RING_BUFFER_BENCH_BATCH) * RING_BUFFER_BENCH_BATCH;
+
+    RingBuffer_BenchSizes (RingBuffer_BenchRunSingle)
+
+    status = 0;
+
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+    status |= RingBuffer_BenchThreads (1U, 1U, items);
+    status |= RingBuffer_BenchPingPong (items);
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+
+#if (RING_BUFFER_PROTECT == 1)
+    status |= RingBuffer_BenchThreads (producers, consumers, items);
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+    return status | (int) (benchSink & 0U);
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Conf.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Ring buffer benchmark configuration (options can be overridden from the command line).
+ */
+
+#ifndef RING_BUFFER_CONF_H__
+#define RING_BUFFER_CONF_H__
+
+/**********************************************************************************************************************
+*           HEADER INCLUDE                                                                                            *
+**********************************************************************************************************************/
+
+/* Standard include. */
+#include <assert.h>
+
+/**
+ * Custom assert function.
+ */
+#define RingBuffer_Assert(pX) assert ((pX))
+
+/**
+ * Enable support for thread-safe operations.
+ */
+#ifndef RING_BUFFER_PROTECT
+    #define RING_BUFFER_PROTECT 1
+#endif /* RING_BUFFER_PROTECT */
+
+/**
+ * Enable lock-free single-producer/single-consumer operations.
+ */
+#ifndef RING_BUFFER_SPSC
+    #define RING_BUFFER_SPSC 0
+#endif /* RING_BUFFER_SPSC */
+
+/**
+ * Enable power-of-two lengths w/ free-running indexes.
+ */
+#ifndef RING_BUFFER_POW2
+    #define RING_BUFFER_POW2 0
+#endif /* RING_BUFFER_POW2 */
+
+/**
+ * Enable cache-line aligned head / tail.
+ */
+#ifndef RING_BUFFER_CACHE_ALIGN
+    #define RING_BUFFER_CACHE_ALIGN 0
+#endif /* RING_BUFFER_CACHE_ALIGN */
+
+/**
+ * Cache line size in bytes.
+ */
+#define RING_BUFFER_CACHE_LINE_SIZE 64
+
+/**********************************************************************************************************************
+*           PUBLIC DEFINES                                                                                            *
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*           PUBLIC TYPES                                                                                              *
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*           PUBLIC VARIABLES                                                                                          *
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*           PUBLIC FUNCTIONS PROTOTYPES                                                                               *
+**********************************************************************************************************************/
+
+#endif /* RING_BUFFER_CONF_H__ */
@@ -0,0 +1,186 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Test.cpp
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Ring buffer C++ template example.
+ */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <cassert>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+/* Ring buffer module. */
+#include "RingBuffer.hpp"
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/**
+ * Message w/ non-trivially-copyable and move-only members.
+ */
+struct Message_t
+{
+    Message_t (std::string text, int value) : text (std::move (text)), ptrValue (std::make_unique<int> (value)) {}
+
+    std::string          text;
+    std::unique_ptr<int> ptrValue;
+};
+
+#if (RING_BUFFER_COROUTINES == 1)
+/**
+ * Fire-and-forget coroutine: runs eagerly until its first suspension, frame freed on completion.
+ */
+struct Task_t
+{
+    struct promise_type
+    {
+        Task_t get_return_object () { return {}; }
+        std::suspend_never initial_suspend () noexcept { return {}; }
+        std::suspend_never final_suspend () noexcept { return {}; }
+        void return_void () {}
+        void unhandled_exception () { std::terminate (); }
+    };
+};
+
+using Pointers_t = RingBuffer<std::unique_ptr<int>, 2U>;
+#endif /* RING_BUFFER_COROUTINES == 1 */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+extern "C" void
+RingBuffer_TestCpp (void);
+
+#if (RING_BUFFER_COROUTINES == 1)
+/**
+ * Awaits count items and records them.
+ */
+static Task_t
+RingBuffer_TestConsume (Pointers_t& ring, int count, std::vector<int>& values)
+{
+    for (int i = 0; i < count; i++)
+    {
+        std::unique_ptr<int> ptrValue = co_await ring.async_pop ();
+
+        values.push_back (*ptrValue);
+    }
+}
+
+/**
+ * Awaits room for count items, numbered from first.
+ */
+static Task_t
+RingBuffer_TestProduce (Pointers_t& ring, int first, int count)
+{
+    for (int i = first; i < (first + count); i++)
+    {
+        co_await ring.async_push (std::make_unique<int> (i));
+    }
+}
+
+/**
+ * Producer and consumer coroutines hand items over w/o threads, whichever side parks first.
+ */
+static void
+RingBuffer_TestCoroutines (void)
+{
+    Pointers_t       ring;
+    std::vector<int> values;
+    int              i;
+
+    /* Consumer parks on the empty ring buffer, each push resumes it. */
+    RingBuffer_TestConsume (ring, 6, values);
+    RingBuffer_TestProduce (ring, 0, 6);
+
+    /* Producer parks on the full ring buffer, each pop resumes it. */
+    RingBuffer_TestProduce (ring, 6, 6);
+
+    assert (ring.full ());
+
+    values.push_back (*ring.pop ());
+    values.push_back (*ring.pop ());
+
+    RingBuffer_TestConsume (ring, 4, values);
+
+    /* Parked consumers are served in FIFO order. */
+    RingBuffer_TestConsume (ring, 1, values);
+    RingBuffer_TestConsume (ring, 1, values);
+
+    (void) ring.try_push (std::make_unique<int> (12));
+    (void) ring.try_push (std::make_unique<int> (13));
+
+    for (i = 0; i < 14; i++)
+    {
+        assert (values[static_cast<std::size_t> (i)] == i);
+    }
+
+    (void) std::printf ("cpp coroutines %zu\n", values.size ());
+
+    assert ((values.size () == 14U) && ring.empty ());
+}
+#endif /* RING_BUFFER_COROUTINES == 1 */
+
+extern "C" void
+RingBuffer_TestCpp (void)
+{
+    RingBuffer<Message_t, 4U, RingBuffer_Protected<std::mutex>> messages;
+    RingBuffer<std::unique_ptr<int>, 3U, RingBuffer_Spsc>       pointers;
+    std::unique_ptr<int>                                         ptrValue;
+    int                                                          i;
+    bool                                                         res;
+
+    static_assert (decltype (messages)::pow2 && (decltype (messages)::capacity () == 4U), "pow2 path expected");
+    static_assert (!decltype (pointers)::pow2 && (decltype (pointers)::length == 4U), "spare slot expected");
+
+    for (i = 0; i < 6; i++)
+    {
+        /* Oldest messages are destroyed in place once full. */
+        messages.emplace ("message " + std::to_string (i), i);
+    }
+
+    res = messages.try_emplace ("rejected", -1);
+
+    assert (messages.full () && !res);
+
+    for (i = 2; i < 6; i++)
+    {
+        Message_t message = messages.pop ();
+
+        (void) std::printf ("cpp pop %s\n", message.text.c_str ());
+
+        assert ((*message.ptrValue == i) && (message.text == ("message " + std::to_string (i))));
+    }
+
+    assert (messages.empty ());
+
+    for (i = 0; i < 4; i++)
+    {
+        /* Full SPSC ring buffer rejects the new item instead of overwriting. */
+        res = pointers.try_push (std::make_unique<int> (i));
+
+        assert (res == (i < 3));
+    }
+
+    res = pointers.try_pop (ptrValue);
+
+    assert (res && (*ptrValue == 0) && (pointers.size () == 2U));
+
+#if (RING_BUFFER_COROUTINES == 1)
+    RingBuffer_TestCoroutines ();
+#endif /* RING_BUFFER_COROUTINES == 1 */
+
+    /* Remaining items are destroyed along w/ the ring buffer. */
+}
@@ -2,12 +2,48 @@
  * Copyright 2021 <Alessandro Morniroli>
  */
 
+// cppcheck-suppress misra-c2012-21.1; required by memfd_create
+#define _GNU_SOURCE
+
 #include <inttypes.h>
 // cppcheck-suppress misra-c2012-21.6; for testing purpose
 #include <stdio.h>
 #include <stdlib.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
 
 #include "RingBuffer.h"
+#define RING_BUFFER_DESC_IMPLEMENTATION
+#include "RingBuffer_Desc.h"
+#include "RingBuffer_Broadcast.h"
+#include "RingBuffer_File.h"
+#include "RingBuffer_Io.h"
+#include "RingBuffer_Mirror.h"
+#include "RingBuffer_Mpmc.h"
+#include "RingBuffer_Record.h"
+#include "RingBuffer_Shard.h"
+#include "RingBuffer_Shm.h"
+
+/* Threaded MPMC test: producers, consumers and items pushed by each producer. */
+#define RING_BUFFER_TEST_MPMC_PRODUCERS 4U
+#define RING_BUFFER_TEST_MPMC_CONSUMERS 4U
+#define RING_BUFFER_TEST_MPMC_ITEMS     50000U
+
+/* Threaded wait test: items moved through the 8-slot ring buffer in each direction. */
+#define RING_BUFFER_TEST_WAIT_ITEMS 50000U
+
+/* Threaded broadcast test: readers and items pushed per policy. */
+#define RING_BUFFER_TEST_BROADCAST_READERS 2U
+#define RING_BUFFER_TEST_BROADCAST_ITEMS   100000U
+
+/* Threaded shard test: producers (one shard each) and items pushed by each producer. */
+#define RING_BUFFER_TEST_SHARD_PRODUCERS 4U
+#define RING_BUFFER_TEST_SHARD_ITEMS     50000U
 
 typedef struct
 {
@@ -15,9 +51,138 @@ typedef struct
     uint32_t x;
 } Item_t;
 
+typedef struct
+{
+    uint32_t id;                                    /**< Producer id (dummy field of pushed items). */
+    uint32_t next[RING_BUFFER_TEST_MPMC_PRODUCERS]; /**< Lowest sequence expected from each producer (consumers). */
+    uint64_t count;                                 /**< Items popped (consumers). */
+    uint64_t sum;                                   /**< Sum of popped sequences (consumers). */
+} MpmcThread_t;
+
+typedef struct
+{
+    int32_t  reader; /**< Reader index. */
+    uint32_t count;  /**< Items popped. */
+} BroadcastThread_t;
+
+typedef struct
+{
+    uint32_t id;    /**< Producer id (dummy field of pushed items). */
+    int32_t  shard; /**< Attached shard. */
+} ShardThread_t;
+
 static void
 RingBuffer_ProtectCallback (uint8_t op, void* ptrArg);
 
+#if (RING_BUFFER_PROTECT == 1)
+static void
+RingBuffer_MutexCallback (uint8_t op, void* ptrArg);
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+static void*
+RingBuffer_TestMpmcProducer (void* ptrArg);
+
+static void*
+RingBuffer_TestMpmcConsumer (void* ptrArg);
+
+static void
+RingBuffer_TestMpmc (void);
+
+static void
+RingBuffer_TestZeroCopy (void);
+
+static void
+RingBuffer_TestBulk (void);
+
+static void
+RingBuffer_TestMirror (void);
+
+#if (RING_BUFFER_WAIT == 1) && ((RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1))
+static void*
+RingBuffer_TestWaitProducer (void* ptrArg);
+
+static void*
+RingBuffer_TestWaitConsumer (void* ptrArg);
+#endif /* (RING_BUFFER_WAIT == 1) && ((RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)) */
+
+static void
+RingBuffer_TestWait (void);
+
+static void
+RingBuffer_TestDesc (void);
+
+static void
+RingBuffer_TestDescMap (void);
+
+static void
+RingBuffer_TestStats (void);
+
+static void
+RingBuffer_TestPolicy (void);
+
+static void
+RingBuffer_TestRecord (void);
+
+static void
+RingBuffer_TestShm (void);
+
+static void*
+RingBuffer_TestBroadcastReader (void* ptrArg);
+
+static void
+RingBuffer_TestBroadcastThreads (uint8_t policy);
+
+static void
+RingBuffer_TestBroadcast (void);
+
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+static void*
+RingBuffer_TestShardProducer (void* ptrArg);
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+
+static void
+RingBuffer_TestShard (void);
+
+static void
+RingBuffer_TestFile (void);
+
+static void
+RingBuffer_TestIo (void);
+
+static void
+RingBuffer_TestCopy (void);
+
+static void
+RingBuffer_TestNotify (void);
+
+/* Defined in RingBuffer_Test.cpp. */
+void
+RingBuffer_TestCpp (void);
+
+RingBuffer_MpmcCreate (static, Item_t, mpmcStress, 16);
+
+static _Atomic uint32_t mpmcPopped;
+
+RingBuffer_BroadcastCreate (static, Item_t, broadcastStress, 16, RING_BUFFER_TEST_BROADCAST_READERS);
+
+#if (RING_BUFFER_WAIT == 1) && (RING_BUFFER_PROTECT == 1)
+/* Lock of the ring buffer shared by the threaded wait test. */
+static pthread_mutex_t testMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif /* (RING_BUFFER_WAIT == 1) && (RING_BUFFER_PROTECT == 1) */
+
+#if (RING_BUFFER_WAIT == 1) && ((RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1))
+RingBuffer_Create (static, Item_t, waitStress, 8, RingBuffer_MutexCallback, &testMutex);
+#endif /* (RING_BUFFER_WAIT == 1) && ((RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)) */
+
+#if (RING_BUFFER_PROTECT == 1)
+/* Locks of the shards fed by the threaded shard test. */
+static pthread_mutex_t shardMutexes[RING_BUFFER_TEST_SHARD_PRODUCERS];
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+RingBuffer_ShardCreate (static, Item_t, shardStress, 16, RING_BUFFER_TEST_SHARD_PRODUCERS);
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+
 int
 main (void)
 {
@@ -31,12 +196,12 @@ main (void)
     uint32_t usedHalf;
     uint32_t used;
     uint32_t available;
-    uint32_t length;
+    uint32_t capacity;
     int32_t  res;
 
-    length = RingBuffer_GetLength (testBuffer);
+    capacity = RingBuffer_GetCapacity (testBuffer);
 
-    for (i = 0U; i < (length - 1U); i++)
+    for (i = 0U; i < capacity; i++)
     {
         (void) memset (&item, 0x00, sizeof (item));
 
@@ -52,7 +217,7 @@ main (void)
 
         (void) printf ("push %"PRIu32" count %"PRIu32"\n", item.x, used);
 
-        assert ((res == 0) && (used == (i + 1UL)) && (available == ((length - 1UL) - used)));
+        assert ((res == 0) && (used == (i + 1UL)) && (available == (capacity - used)));
     }
 
     usedHalf = (RingBuffer_GetUsed (testBuffer) / ((uint32_t) 2));
@@ -71,7 +236,7 @@ main (void)
 
     available = RingBuffer_GetFree (testBuffer);
 
-    assert ((used == ((length - 1UL) - usedHalf)) && (available == usedHalf));
+    assert ((used == (capacity - usedHalf)) && (available == usedHalf));
 
     for (i = 0; i < usedHalf; i++)
     {
@@ -92,7 +257,7 @@ main (void)
 
     available = RingBuffer_GetFree (testBuffer);
 
-    assert ((used == (length - 1UL)) && (available == 0UL));
+    assert ((used == capacity) && (available == 0UL));
 
     item.x = (usedHalf - 1UL);
 
@@ -100,7 +265,7 @@ main (void)
     {
         Item_t popped;
 
-        item.x = ((item.x + 1UL) % (length - 1UL));
+        item.x = ((item.x + 1UL) % capacity);
 
         RingBuffer_Pop (testBuffer, popped);
 
@@ -117,11 +282,47 @@ main (void)
 
     available = RingBuffer_GetFree (testBuffer);
 
-    assert ((used == 0UL) && (available == (length - 1UL)));
+    assert ((used == 0UL) && (available == capacity));
 
     // cppcheck-suppress misra-c2012-21.3; for testing purpose
     free (ptrTemp);
 
+    RingBuffer_TestMpmc ();
+
+    RingBuffer_TestZeroCopy ();
+
+    RingBuffer_TestBulk ();
+
+    RingBuffer_TestMirror ();
+
+    RingBuffer_TestWait ();
+
+    RingBuffer_TestDesc ();
+
+    RingBuffer_TestDescMap ();
+
+    RingBuffer_TestStats ();
+
+    RingBuffer_TestPolicy ();
+
+    RingBuffer_TestRecord ();
+
+    RingBuffer_TestShm ();
+
+    RingBuffer_TestBroadcast ();
+
+    RingBuffer_TestShard ();
+
+    RingBuffer_TestFile ();
+
+    RingBuffer_TestIo ();
+
+    RingBuffer_TestCopy ();
+
+    RingBuffer_TestNotify ();
+
+    RingBuffer_TestCpp ();
+
     return 0;
 }
 
@@ -141,4 +342,1692 @@ RingBuffer_ProtectCallback (uint8_t op, void* ptrArg)
     {
         *ptrTemp = 1;
     }
-}
\ No newline at end of file
+}
+
+#if (RING_BUFFER_PROTECT == 1)
+static void
+RingBuffer_MutexCallback (uint8_t op, void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for testing purpose
+    pthread_mutex_t* ptrMutex = ptrArg;
+
+    if (op == ((uint8_t) RING_BUFFER_UNLOCK))
+    {
+        (void) pthread_mutex_unlock (ptrMutex);
+    }
+    else
+    {
+        (void) pthread_mutex_lock (ptrMutex);
+    }
+}
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+static void*
+RingBuffer_TestMpmcProducer (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for testing purpose
+    MpmcThread_t* ptrThread = ptrArg;
+    uint32_t      i;
+    Item_t        item;
+    int32_t       status;
+
+    item.dummy = (uint8_t) ptrThread->id;
+
+    for (i = 0U; i < RING_BUFFER_TEST_MPMC_ITEMS; i++)
+    {
+        item.x = i;
+
+        RingBuffer_MpmcTryPush (mpmcStress, item, status);
+
+        while (status != RING_BUFFER_OK)
+        {
+            (void) sched_yield ();
+
+            RingBuffer_MpmcTryPush (mpmcStress, item, status);
+        }
+    }
+
+    return NULL;
+}
+
+static void*
+RingBuffer_TestMpmcConsumer (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for testing purpose
+    MpmcThread_t* ptrThread = ptrArg;
+    Item_t        item;
+    int32_t       status;
+
+    while (atomic_load_explicit (&mpmcPopped, memory_order_relaxed) <
+           (RING_BUFFER_TEST_MPMC_PRODUCERS * RING_BUFFER_TEST_MPMC_ITEMS))
+    {
+        RingBuffer_MpmcTryPop (mpmcStress, item, status);
+
+        if (status == RING_BUFFER_OK)
+        {
+            /* Each producer claims its slots in order, so any consumer sees its items in increasing order. */
+            assert ((item.dummy < RING_BUFFER_TEST_MPMC_PRODUCERS) && (item.x >= ptrThread->next[item.dummy]));
+
+            ptrThread->next[item.dummy] = item.x + 1U;
+            ptrThread->count++;
+            ptrThread->sum += item.x;
+
+            (void) atomic_fetch_add_explicit (&mpmcPopped, 1U, memory_order_relaxed);
+        }
+        else
+        {
+            (void) sched_yield ();
+        }
+    }
+
+    return NULL;
+}
+
+static void
+RingBuffer_TestMpmc (void)
+{
+    RingBuffer_MpmcCreate(static, Item_t, mpmcBuffer, 8);
+
+    uint32_t     i;
+    Item_t       item;
+    int32_t      status;
+    int          res;
+    uint64_t     count;
+    uint64_t     sum;
+    pthread_t    threadIds[RING_BUFFER_TEST_MPMC_PRODUCERS + RING_BUFFER_TEST_MPMC_CONSUMERS];
+    MpmcThread_t threads[RING_BUFFER_TEST_MPMC_PRODUCERS + RING_BUFFER_TEST_MPMC_CONSUMERS];
+
+    RingBuffer_MpmcInit (mpmcBuffer);
+
+    for (i = 0U; i < RingBuffer_MpmcGetLength (mpmcBuffer); i++)
+    {
+        item.x = i;
+
+        RingBuffer_MpmcTryPush (mpmcBuffer, item, status);
+
+        assert ((status == RING_BUFFER_OK) && (RingBuffer_MpmcGetUsed (mpmcBuffer) == (i + 1UL)));
+    }
+
+    RingBuffer_MpmcTryPush (mpmcBuffer, item, status);
+
+    assert (status == RING_BUFFER_FULL);
+
+    for (i = 0U; i < RingBuffer_MpmcGetLength (mpmcBuffer); i++)
+    {
+        RingBuffer_MpmcTryPop (mpmcBuffer, item, status);
+
+        (void) printf ("mpmc pop %"PRIu32"\n", item.x);
+
+        assert ((status == RING_BUFFER_OK) && (item.x == i));
+    }
+
+    RingBuffer_MpmcTryPop (mpmcBuffer, item, status);
+
+    assert ((status == RING_BUFFER_EMPTY) && (RingBuffer_MpmcGetUsed (mpmcBuffer) == 0UL));
+
+    /* N producers / M consumers racing on a small ring buffer: CAS contention and wrap-around. */
+    RingBuffer_MpmcInit (mpmcStress);
+
+    atomic_store_explicit (&mpmcPopped, 0U, memory_order_relaxed);
+
+    (void) memset (threads, 0x00, sizeof (threads));
+
+    for (i = 0U; i < (RING_BUFFER_TEST_MPMC_PRODUCERS + RING_BUFFER_TEST_MPMC_CONSUMERS); i++)
+    {
+        threads[i].id = i;
+
+        res = pthread_create (&threadIds[i], NULL,
+                              (i < RING_BUFFER_TEST_MPMC_PRODUCERS) ? RingBuffer_TestMpmcProducer :
+                                                                     RingBuffer_TestMpmcConsumer,
+                              &threads[i]);
+
+        assert (res == 0);
+    }
+
+    count = 0U;
+    sum   = 0U;
+
+    for (i = 0U; i < (RING_BUFFER_TEST_MPMC_PRODUCERS + RING_BUFFER_TEST_MPMC_CONSUMERS); i++)
+    {
+        (void) pthread_join (threadIds[i], NULL);
+
+        count += threads[i].count;
+        sum   += threads[i].sum;
+    }
+
+    (void) printf ("mpmc threads popped %"PRIu64"\n", count);
+
+    assert (count == ((uint64_t) RING_BUFFER_TEST_MPMC_PRODUCERS * RING_BUFFER_TEST_MPMC_ITEMS));
+    assert (sum == (((uint64_t) RING_BUFFER_TEST_MPMC_PRODUCERS * RING_BUFFER_TEST_MPMC_ITEMS *
+                     (RING_BUFFER_TEST_MPMC_ITEMS - 1U)) / 2U));
+    assert (RingBuffer_MpmcGetUsed (mpmcStress) == 0UL);
+}
+
+static void
+RingBuffer_TestZeroCopy (void)
+{
+    uint32_t arg;
+
+    RingBuffer_Create(, Item_t, zeroCopyBuffer, 8, RingBuffer_ProtectCallback, &arg);
+
+    uint32_t i;
+    uint32_t capacity;
+    Item_t   item;
+    Item_t*  ptrFirst;
+    Item_t*  ptrSecond;
+    uint32_t firstSize;
+    uint32_t secondSize;
+
+    capacity = RingBuffer_GetCapacity (zeroCopyBuffer);
+
+    (void) memset (&item, 0x00, sizeof (item));
+
+    /* Move indexes forward so that the reservation wraps around the end of the array. */
+    for (i = 0U; i < 5U; i++)
+    {
+        RingBuffer_Push (zeroCopyBuffer, item);
+
+        RingBuffer_Pop (zeroCopyBuffer, item);
+    }
+
+    RingBuffer_Reserve (zeroCopyBuffer, (capacity + 1UL), ptrFirst, firstSize, ptrSecond, secondSize);
+
+    assert (((firstSize + secondSize) == capacity) && (secondSize > 0UL));
+
+    for (i = 0U; i < firstSize; i++)
+    {
+        ptrFirst[i].x = i;
+    }
+
+    for (i = 0U; i < secondSize; i++)
+    {
+        ptrSecond[i].x = firstSize + i;
+    }
+
+    assert (RingBuffer_IsEmpty (zeroCopyBuffer));
+
+    RingBuffer_Commit (zeroCopyBuffer, capacity);
+
+    assert (RingBuffer_IsFull (zeroCopyBuffer));
+
+    RingBuffer_Peek (zeroCopyBuffer, capacity, ptrFirst, firstSize, ptrSecond, secondSize);
+
+    assert ((firstSize + secondSize) == capacity);
+
+    for (i = 0U; i < capacity; i++)
+    {
+        item = (i < firstSize) ? ptrFirst[i] : ptrSecond[i - firstSize];
+
+        (void) printf ("peek %"PRIu32"\n", item.x);
+
+        assert (item.x == i);
+    }
+
+    RingBuffer_Release (zeroCopyBuffer, (firstSize + secondSize));
+
+    assert (RingBuffer_IsEmpty (zeroCopyBuffer));
+}
+
+static void
+RingBuffer_TestBulk (void)
+{
+    uint32_t arg;
+
+    RingBuffer_Create(, Item_t, bulkBuffer, 8, RingBuffer_ProtectCallback, &arg);
+
+    uint32_t i;
+    uint32_t capacity;
+    uint32_t count;
+    Item_t   items[16];
+    Item_t   popped[16];
+
+    capacity = RingBuffer_GetCapacity (bulkBuffer);
+
+    (void) memset (items, 0x00, sizeof (items));
+
+    for (i = 0U; i < 16U; i++)
+    {
+        items[i].x = i;
+    }
+
+    /* Move indexes forward so that bulk operations wrap around the end of the array. */
+    RingBuffer_PushBulk (bulkBuffer, items, 5U, count);
+
+    RingBuffer_PopBulk (bulkBuffer, popped, 5U, count);
+
+    assert ((count == 5UL) && RingBuffer_IsEmpty (bulkBuffer));
+
+    RingBuffer_PushAll (bulkBuffer, items, (capacity + 1UL), count);
+
+    assert ((count == 0UL) && RingBuffer_IsEmpty (bulkBuffer));
+
+    RingBuffer_PushBulk (bulkBuffer, items, 16U, count);
+
+    assert ((count == capacity) && RingBuffer_IsFull (bulkBuffer));
+
+    RingBuffer_PopAll (bulkBuffer, popped, (capacity + 1UL), count);
+
+    assert ((count == 0UL) && RingBuffer_IsFull (bulkBuffer));
+
+    RingBuffer_PopBulk (bulkBuffer, popped, 16U, count);
+
+    assert ((count == capacity) && RingBuffer_IsEmpty (bulkBuffer));
+
+    for (i = 0U; i < capacity; i++)
+    {
+        (void) printf ("bulk pop %"PRIu32"\n", popped[i].x);
+
+        assert (memcmp (&popped[i], &items[i], sizeof (popped[i])) == 0);
+    }
+}
+
+static void
+RingBuffer_TestMirror (void)
+{
+    RingBuffer_Mirror_t mirror;
+    uint32_t            i;
+    uint32_t            count;
+    uint32_t            size;
+    Item_t              items[8];
+    Item_t*             ptrItems;
+    int32_t             res;
+
+    res = RingBuffer_MirrorCreate (&mirror, sizeof (Item_t), 8U);
+
+    assert ((res == RING_BUFFER_OK) && (RingBuffer_MirrorGetCapacity (&mirror) >= 7UL));
+
+    (void) memset (items, 0x00, sizeof (items));
+
+    /* Move indexes close to the end of the array so that the next push wraps. */
+    (void) RingBuffer_MirrorReserve (&mirror, &size);
+
+    RingBuffer_MirrorCommit (&mirror, (mirror.length - 4UL));
+
+    RingBuffer_MirrorRelease (&mirror, (mirror.length - 4UL));
+
+    for (i = 0U; i < 8U; i++)
+    {
+        items[i].x = i;
+    }
+
+    count = RingBuffer_MirrorPushBulk (&mirror, items, 8U);
+
+    assert (count == 8UL);
+
+    /* Wrapped items are seen as a single contiguous span. */
+    // cppcheck-suppress misra-c2012-11.5; for testing purpose
+    ptrItems = RingBuffer_MirrorPeek (&mirror, &size);
+
+    assert (size == 8UL);
+
+    for (i = 0U; i < size; i++)
+    {
+        (void) printf ("mirror peek %"PRIu32"\n", ptrItems[i].x);
+
+        assert (ptrItems[i].x == i);
+    }
+
+    RingBuffer_MirrorRelease (&mirror, size);
+
+    assert (RingBuffer_MirrorGetUsed (&mirror) == 0UL);
+
+    RingBuffer_MirrorDestroy (&mirror);
+}
+
+#if (RING_BUFFER_WAIT == 1) && ((RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1))
+static void*
+RingBuffer_TestWaitProducer (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for testing purpose
+    const uint32_t* ptrFirst = ptrArg;
+    uint32_t        i;
+    int32_t         status;
+    Item_t          item;
+
+    (void) memset (&item, 0x00, sizeof (item));
+
+    for (i = 0U; i < RING_BUFFER_TEST_WAIT_ITEMS; i++)
+    {
+        item.x = *ptrFirst + i;
+
+        RingBuffer_PushWait (waitStress, item, RING_BUFFER_WAIT_FOREVER, status);
+
+        assert (status == RING_BUFFER_OK);
+    }
+
+    return NULL;
+}
+
+static void*
+RingBuffer_TestWaitConsumer (void* ptrArg)
+{
+    uint32_t i;
+    int32_t  status;
+    Item_t   item;
+
+    for (i = 0U; i < RING_BUFFER_TEST_WAIT_ITEMS; i++)
+    {
+        RingBuffer_PopWait (waitStress, item, RING_BUFFER_WAIT_FOREVER, status);
+
+        assert ((status == RING_BUFFER_OK) && (item.x == i));
+    }
+
+    return ptrArg;
+}
+#endif /* (RING_BUFFER_WAIT == 1) && ((RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)) */
+
+static void
+RingBuffer_TestWait (void)
+{
+#if (RING_BUFFER_WAIT == 1)
+    uint32_t  i;
+    uint32_t  arg;
+    uint32_t  first;
+    int32_t   status;
+    int       res;
+    Item_t    item;
+    pthread_t thread;
+
+    RingBuffer_Create (, Item_t, waitBuffer, 8, RingBuffer_ProtectCallback, &arg);
+
+    RingBuffer_Reset (waitBuffer);
+
+    (void) memset (&item, 0x00, sizeof (item));
+
+    /* Nobody pushes, so the pop times out. */
+    RingBuffer_PopWait (waitBuffer, item, 1U, status);
+
+    assert (status == RING_BUFFER_EMPTY);
+
+    for (i = 0U; i < RingBuffer_GetCapacity (waitBuffer); i++)
+    {
+        item.x = i;
+
+        RingBuffer_PushWait (waitBuffer, item, RING_BUFFER_WAIT_FOREVER, status);
+
+        assert (status == RING_BUFFER_OK);
+    }
+
+    /* Nobody pops, so the push times out instead of overwriting. */
+    RingBuffer_PushWait (waitBuffer, item, 1U, status);
+
+    assert (status == RING_BUFFER_FULL);
+
+    for (i = 0U; i < RingBuffer_GetCapacity (waitBuffer); i++)
+    {
+        RingBuffer_PopWait (waitBuffer, item, RING_BUFFER_WAIT_FOREVER, status);
+
+        (void) printf ("wait pop %"PRIu32"\n", item.x);
+
+        assert ((status == RING_BUFFER_OK) && (item.x == i));
+    }
+
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+    /* Consumer parked on empty ring buffer, woken up by each push. */
+    RingBuffer_Reset (waitStress);
+
+    res = pthread_create (&thread, NULL, RingBuffer_TestWaitConsumer, NULL);
+
+    assert (res == 0);
+
+    while (atomic_load_explicit (&waitStress.headWaiters, memory_order_relaxed) == 0U)
+    {
+        (void) sched_yield ();
+    }
+
+    for (i = 0U; i < RING_BUFFER_TEST_WAIT_ITEMS; i++)
+    {
+        item.x = i;
+
+        RingBuffer_PushWait (waitStress, item, RING_BUFFER_WAIT_FOREVER, status);
+
+        assert (status == RING_BUFFER_OK);
+    }
+
+    (void) pthread_join (thread, NULL);
+
+    /* Producer parked on full ring buffer, woken up by each pop. */
+    for (i = 0U; i < RingBuffer_GetCapacity (waitStress); i++)
+    {
+        item.x = i;
+
+        RingBuffer_PushWait (waitStress, item, RING_BUFFER_WAIT_FOREVER, status);
+    }
+
+    first = RingBuffer_GetCapacity (waitStress);
+    res   = pthread_create (&thread, NULL, RingBuffer_TestWaitProducer, &first);
+
+    assert (res == 0);
+
+    while (atomic_load_explicit (&waitStress.tailWaiters, memory_order_relaxed) == 0U)
+    {
+        (void) sched_yield ();
+    }
+
+    for (i = 0U; i < (first + RING_BUFFER_TEST_WAIT_ITEMS); i++)
+    {
+        RingBuffer_PopWait (waitStress, item, RING_BUFFER_WAIT_FOREVER, status);
+
+        assert ((status == RING_BUFFER_OK) && (item.x == i));
+    }
+
+    (void) pthread_join (thread, NULL);
+
+    (void) printf ("wait threads moved %"PRIu32" items\n", (2U * RING_BUFFER_TEST_WAIT_ITEMS) + first);
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+#endif /* RING_BUFFER_WAIT == 1 */
+}
+
+static void
+RingBuffer_TestDesc (void)
+{
+    RingBuffer_Desc_t ring;
+    uint32_t          i;
+    uint32_t          arg;
+    uint32_t          count;
+    int32_t           res;
+    Item_t            item;
+    Item_t            items[16];
+    Item_t            popped[16];
+
+    /* Capacity chosen at runtime, storage on the heap. */
+    res = RingBuffer_DescAlloc (&ring, sizeof (Item_t), 8U, RingBuffer_ProtectCallback, &arg);
+
+    assert ((res == RING_BUFFER_OK) && (RingBuffer_DescGetUsed (&ring) == 0UL));
+
+    (void) memset (items, 0x00, sizeof (items));
+
+    for (i = 0U; i < 16U; i++)
+    {
+        items[i].x = i;
+    }
+
+    /* Move indexes close to the end of the array so that bulk operations wrap. */
+    RingBuffer_DescFill (&ring, items, 5U);
+
+    RingBuffer_DescEmpty (&ring, popped, 5U);
+
+    count = RingBuffer_DescPushBulk (&ring, items, 16U);
+
+    assert ((count == RingBuffer_DescGetCapacity (&ring)) && (RingBuffer_DescGetFree (&ring) == 0UL));
+
+    count = RingBuffer_DescPopBulk (&ring, popped, 16U);
+
+    assert (count == RingBuffer_DescGetCapacity (&ring));
+
+    for (i = 0U; i < count; i++)
+    {
+        (void) printf ("desc pop %"PRIu32"\n", popped[i].x);
+
+        assert (popped[i].x == i);
+    }
+
+    RingBuffer_DescPush (&ring, &items[3]);
+
+    res = RingBuffer_DescPop (&ring, &item);
+
+    assert ((res == RING_BUFFER_OK) && (item.x == 3UL));
+
+    res = RingBuffer_DescPop (&ring, &item);
+
+    assert (res == RING_BUFFER_EMPTY);
+
+    RingBuffer_DescFree (&ring);
+}
+
+static void
+RingBuffer_TestDescMap (void)
+{
+#if (RING_BUFFER_DESC_MAP == 1)
+    static Item_t     items[4096];
+    static Item_t     popped[4096];
+    static uint8_t    resident[4096];
+    RingBuffer_Desc_t ring;
+    uint32_t          i;
+    uint32_t          arg;
+    uint32_t          count;
+    int32_t           res;
+
+    for (i = 0U; i < 4096U; i++)
+    {
+        items[i].dummy = 0U;
+        items[i].x     = i;
+    }
+
+    /* Explicit huge pages fall back to transparent ones w/o a hugetlbfs pool: storage is aligned either way. */
+    res = RingBuffer_DescMap (&ring, sizeof (Item_t), 65536U,
+                              (RING_BUFFER_DESC_MAP_HUGETLB | RING_BUFFER_DESC_MAP_PREFAULT), 0,
+                              RingBuffer_ProtectCallback, &arg);
+
+    assert ((res == RING_BUFFER_OK) && (((uintptr_t) ring.ptrStorage % RING_BUFFER_DESC_HUGE_PAGE_SIZE) == 0U));
+
+    /* Prefaulted: every page is resident before the first push. */
+    res = mincore (ring.ptrStorage, ring.mapSize, resident);
+
+    assert ((res == 0) && ((ring.mapSize / (size_t) sysconf (_SC_PAGESIZE)) <= sizeof (resident)));
+
+    for (i = 0U; i < (ring.mapSize / (size_t) sysconf (_SC_PAGESIZE)); i++)
+    {
+        assert ((resident[i] & 1U) != 0U);
+    }
+
+    for (i = 0U; i < 40U; i++)
+    {
+        count = RingBuffer_DescPushBulk (&ring, items, 4096U);
+
+        assert (count == 4096U);
+
+        count = RingBuffer_DescPopBulk (&ring, popped, 4096U);
+
+        assert ((count == 4096U) && (memcmp (popped, items, sizeof (items)) == 0));
+    }
+
+    (void) printf ("desc map %zu bytes\n", ring.mapSize);
+
+    RingBuffer_DescFree (&ring);
+
+    /* Plain pages, first touch. */
+    res = RingBuffer_DescMap (&ring, sizeof (Item_t), 64U, 0U, RING_BUFFER_DESC_NODE_ANY, RingBuffer_ProtectCallback,
+                              &arg);
+
+    assert (res == RING_BUFFER_OK);
+
+    RingBuffer_DescPush (&ring, &items[7]);
+    RingBuffer_DescPop (&ring, &popped[0]);
+
+    assert (popped[0].x == 7U);
+
+    RingBuffer_DescFree (&ring);
+
+    /* Out of range node. */
+    res = RingBuffer_DescMap (&ring, sizeof (Item_t), 64U, 0U, RING_BUFFER_DESC_NODE_MAX, RingBuffer_ProtectCallback,
+                              &arg);
+
+    assert ((res == RING_BUFFER_ERROR) && (errno == EINVAL));
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+}
+
+static void
+RingBuffer_TestStats (void)
+{
+#if (RING_BUFFER_STATS == 1)
+    RingBuffer_Stats_t stats;
+    uint32_t           i;
+    uint32_t           arg;
+    uint32_t           capacity;
+    Item_t             item;
+
+    RingBuffer_Create (, Item_t, statsBuffer, 8, RingBuffer_ProtectCallback, &arg);
+
+    RingBuffer_Reset (statsBuffer);
+
+    RingBuffer_ResetStats (statsBuffer);
+
+    (void) memset (&item, 0x00, sizeof (item));
+
+    capacity = RingBuffer_GetCapacity (statsBuffer);
+
+    /* Push 3 items more than capacity. */
+    for (i = 0U; i < (capacity + 3U); i++)
+    {
+        RingBuffer_Push (statsBuffer, item);
+    }
+
+    RingBuffer_Pop (statsBuffer, item);
+
+    RingBuffer_GetStats (statsBuffer, stats);
+
+    (void) printf ("stats pushes %"PRIu64" pops %"PRIu64" overwritten %"PRIu64" dropped %"PRIu64" high-water %"PRIu64
+                   " lock %"PRIu64" max %"PRIu64"\n", stats.pushes, stats.pops, stats.overwritten, stats.dropped,
+                   stats.highWater, stats.lockTime, stats.lockTimeMax);
+
+    /* Full ring buffer either overwrites the oldest items or drops the new ones (SPSC). */
+    assert ((stats.overwritten + stats.dropped) == 3U);
+    assert (((stats.pushes + stats.dropped) == (capacity + 3U)) && (stats.pops == 1U));
+    assert ((stats.highWater == capacity) && (stats.lockTimeMax <= stats.lockTime));
+
+    RingBuffer_ResetStats (statsBuffer);
+
+    RingBuffer_GetStats (statsBuffer, stats);
+
+    assert ((stats.pushes == 0U) && (stats.highWater == 0U) && (stats.lockTime == 0U));
+    assert ((stats.dropped == 0U) && (RingBuffer_GetDropped (statsBuffer) == 0U));
+#endif /* RING_BUFFER_STATS == 1 */
+}
+
+static void
+RingBuffer_TestPolicy (void)
+{
+    Item_t   items[10];
+    Item_t   item;
+    uint32_t i;
+    uint32_t arg;
+    uint32_t count;
+    uint32_t capacity;
+
+    RingBuffer_CreateWithPolicy (, Item_t, rejectBuffer, 8, RING_BUFFER_REJECT, RingBuffer_ProtectCallback, &arg);
+    RingBuffer_CreateWithPolicy (, Item_t, dropBuffer, 8, RING_BUFFER_DROP, RingBuffer_ProtectCallback, &arg);
+    RingBuffer_CreateWithPolicy (, Item_t, blockBuffer, 8, RING_BUFFER_BLOCK, RingBuffer_ProtectCallback, &arg);
+    RingBuffer_Create (, Item_t, overwriteBuffer, 8, RingBuffer_ProtectCallback, &arg);
+
+    (void) memset (items, 0x00, sizeof (items));
+
+    for (i = 0U; i < 10U; i++)
+    {
+        items[i].x = i;
+    }
+
+    capacity = RingBuffer_GetCapacity (rejectBuffer);
+
+    /* Reject is all or nothing and records nothing. */
+    RingBuffer_FillCount (rejectBuffer, items, (capacity + 1U), count);
+
+    assert ((count == 0U) && RingBuffer_IsEmpty (rejectBuffer));
+
+    RingBuffer_FillCount (rejectBuffer, items, capacity, count);
+
+    assert ((count == capacity) && RingBuffer_IsFull (rejectBuffer));
+
+    RingBuffer_PushCount (rejectBuffer, items[0], count);
+
+    assert ((count == 0U) && (RingBuffer_GetDropped (rejectBuffer) == 0U));
+
+    /* Drop pushes what fits and counts the rest. */
+    RingBuffer_FillCount (dropBuffer, items, (capacity - 1U), count);
+    RingBuffer_FillCount (dropBuffer, &items[capacity - 1U], 3U, count);
+
+    assert ((count == 1U) && (RingBuffer_GetDropped (dropBuffer) == 2U));
+
+    RingBuffer_PushCount (dropBuffer, items[0], count);
+
+    assert ((count == 0U) && (RingBuffer_GetDropped (dropBuffer) == 3U));
+
+    /* Overwrite keeps the newest items (SPSC keeps the oldest ones and drops the others). */
+    RingBuffer_FillCount (overwriteBuffer, items, 10U, count);
+
+    RingBuffer_Pop (overwriteBuffer, item);
+
+    (void) printf ("policy overwrite count %"PRIu32" dropped %"PRIu32" pop %"PRIu32"\n", count,
+                   RingBuffer_GetDropped (overwriteBuffer), item.x);
+
+    assert ((count + RingBuffer_GetDropped (overwriteBuffer)) == 10U);
+    assert (item.x == ((10U - capacity) - RingBuffer_GetDropped (overwriteBuffer)));
+
+    /* Block does not wait while there is room. */
+    RingBuffer_PushCount (blockBuffer, items[0], count);
+
+    assert (count == 1U);
+
+    RingBuffer_FillCount (blockBuffer, &items[1], (capacity - 1U), count);
+
+    assert ((count == (capacity - 1U)) && RingBuffer_IsFull (blockBuffer));
+}
+
+static void
+RingBuffer_TestRecord (void)
+{
+    uint8_t* ptrRecord;
+    uint32_t i;
+    uint32_t j;
+    uint32_t arg;
+    uint32_t size;
+    uint32_t pushed;
+    uint32_t popped;
+
+    RingBuffer_Create (, uint8_t, recordBuffer, 64, RingBuffer_ProtectCallback, &arg);
+
+    /* Record larger than the ring buffer never fits. */
+    RingBuffer_RecordReserve (recordBuffer, 64U, ptrRecord);
+
+    assert (ptrRecord == NULL);
+
+    pushed = 0U;
+    popped = 0U;
+
+    /* Records of 1 to 23 bytes, one consumed every other push, so they wrap around several times. */
+    for (i = 0U; i < 40U; i++)
+    {
+        size = (i % 23U) + 1U;
+
+        RingBuffer_RecordReserve (recordBuffer, size, ptrRecord);
+
+        while (ptrRecord == NULL)
+        {
+            uint32_t poppedSize;
+
+            RingBuffer_RecordPeek (recordBuffer, ptrRecord, poppedSize);
+
+            assert ((ptrRecord != NULL) && (poppedSize == ((popped % 23U) + 1U)));
+
+            for (j = 0U; j < poppedSize; j++)
+            {
+                assert (ptrRecord[j] == (uint8_t) (popped + j));
+            }
+
+            RingBuffer_RecordConsume (recordBuffer, ptrRecord);
+
+            popped++;
+
+            RingBuffer_RecordReserve (recordBuffer, size, ptrRecord);
+        }
+
+        for (j = 0U; j < size; j++)
+        {
+            ptrRecord[j] = (uint8_t) (i + j);
+        }
+
+        RingBuffer_RecordCommit (recordBuffer, ptrRecord, size);
+
+        pushed++;
+    }
+
+    while (popped < pushed)
+    {
+        RingBuffer_RecordPeek (recordBuffer, ptrRecord, size);
+
+        assert ((ptrRecord != NULL) && (size == ((popped % 23U) + 1U)) && (ptrRecord[0] == (uint8_t) popped));
+
+        RingBuffer_RecordConsume (recordBuffer, ptrRecord);
+
+        popped++;
+    }
+
+    RingBuffer_RecordPeek (recordBuffer, ptrRecord, size);
+
+    (void) printf ("record pushed %"PRIu32" popped %"PRIu32"\n", pushed, popped);
+
+    assert ((ptrRecord == NULL) && (size == 0U) && RingBuffer_IsEmpty (recordBuffer));
+}
+
+static void
+RingBuffer_TestShm (void)
+{
+    RingBuffer_Shm_t producer;
+    RingBuffer_Shm_t consumer;
+    Item_t           items[5];
+    uint32_t         i;
+    uint32_t         count;
+    int32_t          res;
+    int32_t          status;
+    pid_t            pid;
+    int              fd;
+
+    (void) memset (items, 0x00, sizeof (items));
+
+    /* Same memfd mapped twice, as two processes would: the layout holds no pointer. */
+    res = RingBuffer_ShmCreate (&producer, NULL, sizeof (Item_t), 7U);
+
+    assert (res == RING_BUFFER_OK);
+
+    res = RingBuffer_ShmAttachFd (&consumer, dup (producer.fd));
+
+    assert ((res == RING_BUFFER_OK) && (consumer.ptrHeader != producer.ptrHeader));
+    assert (RingBuffer_ShmGetCapacity (&consumer) == 7U);
+
+    for (i = 0U; i < 3U; i++)
+    {
+        /* 5 items pushed, 5 popped: indexes wrap around the 8 slots. */
+        count = RingBuffer_ShmPushBulk (&producer, items, 5U);
+
+        assert ((count == 5U) && (RingBuffer_ShmGetUsed (&consumer) == 5U));
+
+        count = RingBuffer_ShmPopBulk (&consumer, items, 5U);
+
+        assert ((count == 5U) && (RingBuffer_ShmGetFree (&producer) == 7U));
+    }
+
+    /* Out of range index written by the peer: nothing is copied. */
+    producer.ptrHeader->head = 8U;
+
+    count = RingBuffer_ShmPushBulk (&producer, items, 1U) + RingBuffer_ShmPopBulk (&consumer, items, 1U);
+
+    assert ((count == 0U) && (RingBuffer_ShmGetUsed (&consumer) == 7U));
+
+    RingBuffer_ShmDetach (&consumer);
+    RingBuffer_ShmDetach (&producer);
+
+    /* Segment w/o header is refused. */
+    fd  = memfd_create ("RingBuffer_Test", 0U);
+    res = RingBuffer_ShmAttachFd (&consumer, fd);
+
+    assert (res == RING_BUFFER_ERROR);
+
+    (void) close (fd);
+
+    RingBuffer_ShmUnlink ("/RingBuffer_Test");
+
+    res = RingBuffer_ShmCreate (&consumer, "/RingBuffer_Test", sizeof (Item_t), 4U);
+
+    assert (res == RING_BUFFER_OK);
+
+    pid = fork ();
+
+    assert (pid >= 0);
+
+    if (pid == 0)
+    {
+        /* Producer process attaches by name. */
+        res = RingBuffer_ShmAttach (&producer, "/RingBuffer_Test");
+
+        for (i = 0U; (res == RING_BUFFER_OK) && (i < 100U); i++)
+        {
+            items[0].x = i;
+
+            while (RingBuffer_ShmPush (&producer, &items[0]) != RING_BUFFER_OK)
+            {
+                (void) sched_yield ();
+            }
+        }
+
+        _exit ((res == RING_BUFFER_OK) ? 0 : 1);
+    }
+    else
+    {
+    }
+
+    for (i = 0U; i < 100U; i++)
+    {
+        while (RingBuffer_ShmPop (&consumer, &items[0]) != RING_BUFFER_OK)
+        {
+            (void) sched_yield ();
+        }
+
+        assert (items[0].x == i);
+    }
+
+    (void) waitpid (pid, &status, 0);
+
+    (void) printf ("shm popped %"PRIu32" from process %d\n", i, (int) pid);
+
+    assert (WIFEXITED (status) && (WEXITSTATUS (status) == 0));
+
+    RingBuffer_ShmDetach (&consumer);
+
+    RingBuffer_ShmUnlink ("/RingBuffer_Test");
+}
+
+static void*
+RingBuffer_TestBroadcastReader (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for testing purpose
+    BroadcastThread_t* ptrThread = ptrArg;
+    uint32_t           next;
+    int32_t            status;
+    Item_t             item;
+
+    next = 0U;
+
+    while (next < RING_BUFFER_TEST_BROADCAST_ITEMS)
+    {
+        RingBuffer_BroadcastTryPop (broadcastStress, ptrThread->reader, item, status);
+
+        if (status == RING_BUFFER_OK)
+        {
+            /* A torn copy (dummy written from a different x) must have been discarded by the re-check. */
+            assert ((item.dummy == (uint8_t) item.x) && (item.x >= next));
+
+            next = item.x + 1U;
+            ptrThread->count++;
+        }
+        else
+        {
+            (void) sched_yield ();
+        }
+    }
+
+    return NULL;
+}
+
+static void
+RingBuffer_TestBroadcastThreads (uint8_t policy)
+{
+    BroadcastThread_t threads[RING_BUFFER_TEST_BROADCAST_READERS];
+    pthread_t         threadIds[RING_BUFFER_TEST_BROADCAST_READERS];
+    uint32_t          i;
+    uint32_t          lag;
+    int32_t           reader;
+    int32_t           status;
+    int               res;
+    Item_t            item;
+
+    RingBuffer_BroadcastInit (broadcastStress, policy);
+
+    for (i = 0U; i < RING_BUFFER_TEST_BROADCAST_READERS; i++)
+    {
+        RingBuffer_BroadcastAttach (broadcastStress, reader);
+
+        assert (reader >= 0);
+
+        threads[i].reader = reader;
+        threads[i].count  = 0U;
+
+        res = pthread_create (&threadIds[i], NULL, RingBuffer_TestBroadcastReader, &threads[i]);
+
+        assert (res == 0);
+    }
+
+    for (i = 0U; i < RING_BUFFER_TEST_BROADCAST_ITEMS; i++)
+    {
+        item.dummy = (uint8_t) i;
+        item.x     = i;
+
+        RingBuffer_BroadcastTryPush (broadcastStress, item, status);
+
+        /* Gated by the slowest reader (reject) or never (overwrite). */
+        while (status != RING_BUFFER_OK)
+        {
+            (void) sched_yield ();
+
+            RingBuffer_BroadcastTryPush (broadcastStress, item, status);
+        }
+
+        if ((i % 64U) == 0U)
+        {
+            (void) sched_yield ();
+        }
+        else
+        {
+        }
+    }
+
+    for (i = 0U; i < RING_BUFFER_TEST_BROADCAST_READERS; i++)
+    {
+        (void) pthread_join (threadIds[i], NULL);
+
+        lag = RingBuffer_BroadcastGetLag (broadcastStress, threads[i].reader);
+
+        (void) printf ("broadcast threads policy %"PRIu8" reader %"PRId32" popped %"PRIu32" lag %"PRIu32"\n", policy,
+                       threads[i].reader, threads[i].count, lag);
+
+        /* Every item is either read or counted as missed, and none is missed unless overrun is allowed. */
+        assert ((threads[i].count + lag) == RING_BUFFER_TEST_BROADCAST_ITEMS);
+        assert ((policy == RING_BUFFER_OVERWRITE) || (lag == 0U));
+
+        RingBuffer_BroadcastDetach (broadcastStress, threads[i].reader);
+    }
+}
+
+static void
+RingBuffer_TestBroadcast (void)
+{
+    uint32_t i;
+    int32_t  status;
+    int32_t  fast;
+    int32_t  slow;
+    int32_t  extra;
+    Item_t   item;
+
+    RingBuffer_BroadcastCreate (static, Item_t, gateBuffer, 8, 2);
+    RingBuffer_BroadcastCreate (static, Item_t, overrunBuffer, 8, 1);
+
+    (void) memset (&item, 0x00, sizeof (item));
+
+    RingBuffer_BroadcastInit (gateBuffer, RING_BUFFER_REJECT);
+
+    RingBuffer_BroadcastAttach (gateBuffer, fast);
+    RingBuffer_BroadcastAttach (gateBuffer, slow);
+    RingBuffer_BroadcastAttach (gateBuffer, extra);
+
+    assert ((fast == 0) && (slow == 1) && (extra < 0));
+
+    for (i = 0U; i < 8U; i++)
+    {
+        item.x = i;
+
+        RingBuffer_BroadcastTryPush (gateBuffer, item, status);
+
+        assert (status == RING_BUFFER_OK);
+    }
+
+    /* Each item is written once and read by both readers at their own pace. */
+    for (i = 0U; i < 8U; i++)
+    {
+        RingBuffer_BroadcastTryPop (gateBuffer, fast, item, status);
+
+        assert ((status == RING_BUFFER_OK) && (item.x == i));
+    }
+
+    /* The slow reader is a whole ring buffer behind, so it gates the producer. */
+    RingBuffer_BroadcastTryPush (gateBuffer, item, status);
+
+    assert (status == RING_BUFFER_FULL);
+
+    RingBuffer_BroadcastTryPop (gateBuffer, slow, item, status);
+
+    assert ((status == RING_BUFFER_OK) && (item.x == 0U));
+
+    RingBuffer_BroadcastTryPush (gateBuffer, item, status);
+
+    assert (status == RING_BUFFER_OK);
+
+    /* A detached reader no longer gates the producer. */
+    RingBuffer_BroadcastDetach (gateBuffer, slow);
+
+    RingBuffer_BroadcastTryPush (gateBuffer, item, status);
+
+    assert (status == RING_BUFFER_OK);
+
+    RingBuffer_BroadcastInit (overrunBuffer, RING_BUFFER_OVERWRITE);
+
+    RingBuffer_BroadcastAttach (overrunBuffer, slow);
+
+    for (i = 0U; i < 20U; i++)
+    {
+        item.x = i;
+
+        RingBuffer_BroadcastTryPush (overrunBuffer, item, status);
+
+        assert (status == RING_BUFFER_OK);
+    }
+
+    /* The laggard skips to the oldest item left and counts the missed ones. */
+    RingBuffer_BroadcastTryPop (overrunBuffer, slow, item, status);
+
+    (void) printf ("broadcast overrun pop %"PRIu32" lag %"PRIu32"\n", item.x,
+                   RingBuffer_BroadcastGetLag (overrunBuffer, slow));
+
+    assert ((status == RING_BUFFER_OK) && (item.x == 13U) && (RingBuffer_BroadcastGetLag (overrunBuffer, slow) == 13U));
+
+    for (i = 14U; i < 20U; i++)
+    {
+        RingBuffer_BroadcastTryPop (overrunBuffer, slow, item, status);
+
+        assert ((status == RING_BUFFER_OK) && (item.x == i));
+    }
+
+    RingBuffer_BroadcastTryPop (overrunBuffer, slow, item, status);
+
+    assert (status == RING_BUFFER_EMPTY);
+
+    /* One producer and two readers running concurrently. */
+    RingBuffer_TestBroadcastThreads (RING_BUFFER_REJECT);
+
+    RingBuffer_TestBroadcastThreads (RING_BUFFER_OVERWRITE);
+}
+
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+static void*
+RingBuffer_TestShardProducer (void* ptrArg)
+{
+    // cppcheck-suppress misra-c2012-11.5; for testing purpose
+    ShardThread_t* ptrThread = ptrArg;
+    uint32_t       i;
+    int32_t        shard;
+    int32_t        status;
+    Item_t         item;
+
+    RingBuffer_ShardAttach (shardStress, shard);
+
+    assert (shard >= 0);
+
+    ptrThread->shard = shard;
+    item.dummy       = (uint8_t) ptrThread->id;
+
+    for (i = 0U; i < RING_BUFFER_TEST_SHARD_ITEMS; i++)
+    {
+        item.x = i;
+
+        RingBuffer_TryPush (RingBuffer_ShardGet (shardStress, shard), item, status);
+
+        while (status != RING_BUFFER_OK)
+        {
+            (void) sched_yield ();
+
+            RingBuffer_TryPush (RingBuffer_ShardGet (shardStress, shard), item, status);
+        }
+    }
+
+    RingBuffer_ShardDetach (shardStress, shard);
+
+    return NULL;
+}
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+
+static void
+RingBuffer_TestShard (void)
+{
+    uint32_t      i;
+    uint32_t      count;
+    uint32_t      total;
+    uint32_t      sum;
+    uint32_t      args[4];
+    int32_t       shard;
+    int32_t       extra;
+    Item_t        item;
+    Item_t        items[32];
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+    ShardThread_t threads[RING_BUFFER_TEST_SHARD_PRODUCERS];
+    pthread_t     threadIds[RING_BUFFER_TEST_SHARD_PRODUCERS];
+    uint32_t      next[RING_BUFFER_TEST_SHARD_PRODUCERS];
+    uint64_t      drained;
+    uint64_t      drainedSum;
+    int           res;
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+
+    RingBuffer_ShardCreate (static, Item_t, shardBuffer, 8, 4);
+
+    (void) memset (&item, 0x00, sizeof (item));
+    (void) memset (args, 0x00, sizeof (args));
+
+    RingBuffer_ShardInit (shardBuffer, RING_BUFFER_REJECT, RingBuffer_ProtectCallback, args);
+
+    for (i = 0U; i < RingBuffer_ShardGetCount (shardBuffer); i++)
+    {
+        RingBuffer_ShardAttach (shardBuffer, shard);
+
+        assert (shard >= 0);
+    }
+
+    /* Shards are shared only if they are protected. */
+    RingBuffer_ShardAttach (shardBuffer, extra);
+
+    assert ((extra >= 0) == (RING_BUFFER_PROTECT == 1));
+
+    RingBuffer_ShardDetach (shardBuffer, 3);
+
+    RingBuffer_ShardAttach (shardBuffer, shard);
+
+    assert (shard == 3);
+
+    /* Ascending keys scattered over the shards come out merged in order. */
+    for (i = 0U; i < 24U; i++)
+    {
+        item.x = i;
+
+        RingBuffer_Push (RingBuffer_ShardGet (shardBuffer, (i * 3U) % 4U), item);
+    }
+
+    RingBuffer_ShardMerge (shardBuffer, x, items, 10U, count);
+
+    assert (count == 10U);
+
+    RingBuffer_ShardMerge (shardBuffer, x, &items[10], 22U, count);
+
+    (void) printf ("shard merge count %"PRIu32"\n", count + 10U);
+
+    assert (count == 14U);
+
+    for (i = 0U; i < 24U; i++)
+    {
+        assert (items[i].x == i);
+    }
+
+    /* Drain collects every shard, a bulk pop each. */
+    sum = 0U;
+
+    for (i = 0U; i < 20U; i++)
+    {
+        item.x = i;
+        sum   += i;
+
+        RingBuffer_Push (RingBuffer_ShardGet (shardBuffer, i % 4U), item);
+    }
+
+    RingBuffer_ShardDrain (shardBuffer, items, 8U, count);
+
+    assert (count == 8U);
+
+    total = count;
+
+    RingBuffer_ShardDrain (shardBuffer, &items[8], 24U, count);
+
+    total += count;
+
+    (void) printf ("shard drain count %"PRIu32"\n", total);
+
+    assert (total == 20U);
+
+    for (i = 0U; i < 20U; i++)
+    {
+        sum -= items[i].x;
+    }
+
+    assert (sum == 0U);
+
+    for (i = 0U; i < RingBuffer_ShardGetCount (shardBuffer); i++)
+    {
+        assert (RingBuffer_GetUsed (RingBuffer_ShardGet (shardBuffer, i)) == 0U);
+    }
+
+#if (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1)
+    /* Attached producers feeding a collector that drains while they push. */
+#if (RING_BUFFER_PROTECT == 1)
+    for (i = 0U; i < RING_BUFFER_TEST_SHARD_PRODUCERS; i++)
+    {
+        res = pthread_mutex_init (&shardMutexes[i], NULL);
+
+        assert (res == 0);
+    }
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+    RingBuffer_ShardInit (shardStress, RING_BUFFER_REJECT, RingBuffer_MutexCallback, shardMutexes);
+
+    (void) memset (next, 0x00, sizeof (next));
+
+    for (i = 0U; i < RING_BUFFER_TEST_SHARD_PRODUCERS; i++)
+    {
+        threads[i].id    = i;
+        threads[i].shard = -1;
+
+        res = pthread_create (&threadIds[i], NULL, RingBuffer_TestShardProducer, &threads[i]);
+
+        assert (res == 0);
+    }
+
+    drained    = 0U;
+    drainedSum = 0U;
+
+    while (drained < ((uint64_t) RING_BUFFER_TEST_SHARD_PRODUCERS * RING_BUFFER_TEST_SHARD_ITEMS))
+    {
+        RingBuffer_ShardDrain (shardStress, items, 32U, count);
+
+        for (i = 0U; i < count; i++)
+        {
+            /* Each producer owns its shard, so its items are drained in push order. */
+            assert ((items[i].dummy < RING_BUFFER_TEST_SHARD_PRODUCERS) && (items[i].x == next[items[i].dummy]));
+
+            next[items[i].dummy]++;
+            drainedSum += items[i].x;
+        }
+
+        drained += count;
+
+        if (count == 0U)
+        {
+            (void) sched_yield ();
+        }
+        else
+        {
+        }
+    }
+
+    for (i = 0U; i < RING_BUFFER_TEST_SHARD_PRODUCERS; i++)
+    {
+        (void) pthread_join (threadIds[i], NULL);
+
+        assert ((threads[i].shard >= 0) && (next[i] == RING_BUFFER_TEST_SHARD_ITEMS));
+    }
+
+    (void) printf ("shard threads drained %"PRIu64"\n", drained);
+
+    assert (drained == ((uint64_t) RING_BUFFER_TEST_SHARD_PRODUCERS * RING_BUFFER_TEST_SHARD_ITEMS));
+    assert (drainedSum == (((uint64_t) RING_BUFFER_TEST_SHARD_PRODUCERS * RING_BUFFER_TEST_SHARD_ITEMS *
+                            (RING_BUFFER_TEST_SHARD_ITEMS - 1U)) / 2U));
+
+    for (i = 0U; i < RingBuffer_ShardGetCount (shardStress); i++)
+    {
+        assert (RingBuffer_GetUsed (RingBuffer_ShardGet (shardStress, i)) == 0U);
+    }
+
+#if (RING_BUFFER_PROTECT == 1)
+    for (i = 0U; i < RING_BUFFER_TEST_SHARD_PRODUCERS; i++)
+    {
+        (void) pthread_mutex_destroy (&shardMutexes[i]);
+    }
+#endif /* RING_BUFFER_PROTECT == 1 */
+#endif /* (RING_BUFFER_PROTECT == 1) || (RING_BUFFER_SPSC == 1) */
+}
+
+static void
+RingBuffer_TestFile (void)
+{
+    RingBuffer_File_t recorder;
+    const Item_t*     ptrItem;
+    Item_t            items[10];
+    char              path[] = "/tmp/RingBuffer_TestXXXXXX";
+    uint32_t          i;
+    int32_t           res;
+    int32_t           status;
+    pid_t             pid;
+    int               fd;
+
+    (void) memset (items, 0x00, sizeof (items));
+
+    fd = mkstemp (path);
+
+    assert (fd >= 0);
+
+    (void) close (fd);
+
+    pid = fork ();
+
+    assert (pid >= 0);
+
+    if (pid == 0)
+    {
+        /* Writer process crashes w/o closing nor syncing the file. */
+        res = RingBuffer_FileOpen (&recorder, path, sizeof (Item_t), 8U);
+
+        for (i = 0U; (res == RING_BUFFER_OK) && (i < 20U); i++)
+        {
+            items[0].x = i;
+
+            RingBuffer_FileAppend (&recorder, &items[0]);
+        }
+
+        (void) raise (SIGKILL);
+    }
+    else
+    {
+    }
+
+    (void) waitpid (pid, &status, 0);
+
+    assert (WIFSIGNALED (status));
+
+    /* Post-mortem: the last 8 records are recovered in order. */
+    res = RingBuffer_FileAttach (&recorder, path);
+
+    assert ((res == RING_BUFFER_OK) && (RingBuffer_FileGetCount (&recorder) == 8U));
+    assert (RingBuffer_FileGetFirst (&recorder) == 12U);
+
+    for (i = 0U; i < RingBuffer_FileGetCount (&recorder); i++)
+    {
+        ptrItem = RingBuffer_FileGetRecord (&recorder, i);
+
+        assert ((ptrItem != NULL) && (ptrItem->x == (12U + i)));
+    }
+
+    assert (RingBuffer_FileGetRecord (&recorder, 8U) == NULL);
+
+    (void) printf ("file recovered %"PRIu32" records from process %d\n", i, (int) pid);
+
+    RingBuffer_FileClose (&recorder);
+
+    /* Restart resumes after the last record. */
+    res = RingBuffer_FileOpen (&recorder, path, sizeof (Item_t), 8U);
+
+    assert ((res == RING_BUFFER_OK) && (RingBuffer_FileGetCount (&recorder) == 8U));
+
+    for (i = 0U; i < 10U; i++)
+    {
+        items[i].x = 100U + i;
+    }
+
+    RingBuffer_FileAppendBulk (&recorder, items, 3U);
+    RingBuffer_FileAppendBulk (&recorder, &items[3], 7U);
+
+    assert ((RingBuffer_FileGetCount (&recorder) == 8U) && (RingBuffer_FileGetFirst (&recorder) == 22U));
+
+    for (i = 0U; i < 8U; i++)
+    {
+        ptrItem = RingBuffer_FileGetRecord (&recorder, i);
+
+        assert (ptrItem->x == (102U + i));
+    }
+
+    res = RingBuffer_FileSync (&recorder, 1U);
+
+    assert (res == RING_BUFFER_OK);
+
+    RingBuffer_FileClose (&recorder);
+
+    /* Different geometry resets the file. */
+    res = RingBuffer_FileOpen (&recorder, path, sizeof (Item_t), 16U);
+
+    assert ((res == RING_BUFFER_OK) && (RingBuffer_FileGetCount (&recorder) == 0U));
+
+    RingBuffer_FileClose (&recorder);
+
+    (void) unlink (path);
+}
+
+static void
+RingBuffer_TestIo (void)
+{
+    static uint8_t  scratch[8192];
+    static uint32_t arg;
+    uint32_t        i;
+    ssize_t         res;
+    int             fds[2];
+
+    RingBuffer_Create (static, uint8_t, txBuffer, 8192, RingBuffer_ProtectCallback, &arg);
+    RingBuffer_Create (static, uint8_t, rxBuffer, 8192, RingBuffer_ProtectCallback, &arg);
+
+    for (i = 0U; i < sizeof (scratch); i++)
+    {
+        scratch[i] = (uint8_t) (i % 251U);
+    }
+
+    /* Move the indexes so that the used bytes wrap around. */
+    RingBuffer_Fill (txBuffer, scratch, 5000U);
+    RingBuffer_Empty (scratch, txBuffer, 5000U);
+    RingBuffer_Fill (txBuffer, scratch, 6000U);
+
+    res = pipe (fds);
+
+    assert (res == 0);
+
+    /* A pipe smaller than the data forces a partial write. */
+    (void) fcntl (fds[0], F_SETPIPE_SZ, 4096);
+    (void) fcntl (fds[1], F_SETFL, O_NONBLOCK);
+
+    RingBuffer_WriteFd (txBuffer, fds[1], res);
+
+    (void) printf ("io partial write %zd used %"PRIu32"\n", res, RingBuffer_GetUsed (txBuffer));
+
+    assert ((res > 0) && (res < 6000) && (RingBuffer_GetUsed (txBuffer) == (6000U - (uint32_t) res)));
+
+    RingBuffer_WriteFd (txBuffer, fds[1], res);
+
+    assert ((res < 0) && (errno == EAGAIN));
+
+    RingBuffer_ReadFd (rxBuffer, fds[0], res);
+
+    assert (res > 0);
+
+    while (RingBuffer_GetUsed (txBuffer) > 0U)
+    {
+        RingBuffer_WriteFd (txBuffer, fds[1], res);
+
+        assert (res > 0);
+
+        RingBuffer_ReadFd (rxBuffer, fds[0], res);
+
+        assert (res > 0);
+    }
+
+    assert (RingBuffer_GetUsed (rxBuffer) == 6000U);
+
+    for (i = 0U; i < 6000U; i++)
+    {
+        assert (rxBuffer.array[i] == (uint8_t) (i % 251U));
+    }
+
+    (void) close (fds[0]);
+    (void) close (fds[1]);
+
+    /* Same bytes back over a socket. */
+    res = socketpair (AF_UNIX, SOCK_STREAM, 0, fds);
+
+    assert (res == 0);
+
+    RingBuffer_SendMsg (rxBuffer, fds[0], MSG_DONTWAIT, res);
+
+    assert ((res == 6000) && (RingBuffer_GetUsed (rxBuffer) == 0U));
+
+    RingBuffer_SendMsg (rxBuffer, fds[0], MSG_DONTWAIT, res);
+
+    assert (res == 0);
+
+    RingBuffer_RecvMsg (txBuffer, fds[1], MSG_DONTWAIT, res);
+
+    assert ((res == 6000) && (RingBuffer_GetUsed (txBuffer) == 6000U));
+
+    RingBuffer_Fill (txBuffer, scratch, RingBuffer_GetFree (txBuffer));
+
+    RingBuffer_RecvMsg (txBuffer, fds[1], MSG_DONTWAIT, res);
+
+    assert ((res < 0) && (errno == ENOBUFS));
+
+    (void) close (fds[0]);
+    (void) close (fds[1]);
+}
+
+static void
+RingBuffer_TestCopy (void)
+{
+    static uint8_t  source[65536];
+    static uint8_t  dest[65536 + 64];
+    static uint32_t arg;
+    uint32_t        i;
+    uint32_t        offset;
+    uint32_t        size;
+
+    RingBuffer_Create (static, uint8_t, copyBuffer, 65536, RingBuffer_ProtectCallback, &arg);
+
+    for (i = 0U; i < sizeof (source); i++)
+    {
+        source[i] = (uint8_t) ((i * 7U) % 253U);
+    }
+
+    /* Misaligned destinations and odd sizes, below and above the threshold. */
+    for (offset = 0U; offset < 64U; offset += 13U)
+    {
+        for (size = 1000U; size < sizeof (source); size = (size * 3U) + 1U)
+        {
+            (void) memset (dest, 0x00, sizeof (dest));
+
+            RingBuffer_CopyBytes (&dest[offset], source, size);
+
+            assert ((memcmp (&dest[offset], source, size) == 0) && (dest[offset + size] == 0U));
+#if (RING_BUFFER_COPY_X86 == 1)
+            /* Narrower kernels too, whichever one the CPU selects. */
+            (void) memset (dest, 0x00, sizeof (dest));
+
+            RingBuffer_CopyStreamSse2 (&dest[offset], source, size);
+
+            assert ((memcmp (&dest[offset], source, size) == 0) && (dest[offset + size] == 0U));
+
+            if (__builtin_cpu_supports ("avx2"))
+            {
+                (void) memset (dest, 0x00, sizeof (dest));
+
+                RingBuffer_CopyStreamAvx2 (&dest[offset], source, size);
+
+                assert ((memcmp (&dest[offset], source, size) == 0) && (dest[offset + size] == 0U));
+            }
+            else
+            {
+            }
+#endif /* RING_BUFFER_COPY_X86 == 1 */
+        }
+    }
+
+    /* Bulk operations wrapping around a large ring buffer. */
+    RingBuffer_Fill (copyBuffer, source, 40000U);
+    RingBuffer_Empty (dest, copyBuffer, 40000U);
+    RingBuffer_Fill (copyBuffer, source, 50000U);
+    RingBuffer_Empty (dest, copyBuffer, 50000U);
+
+    (void) printf ("copy stream %d threshold %d\n", RING_BUFFER_COPY_STREAM, RING_BUFFER_COPY_THRESHOLD);
+
+    assert (memcmp (dest, source, 50000U) == 0);
+}
+
+#if (RING_BUFFER_NOTIFY == 1)
+/**
+ * Checks if the readiness notifier fd is readable, as an event loop would see it.
+ *
+ * @param fd Eventfd.
+ *
+ * @return Number of coalesced signals (0 if not readable).
+ */
+static uint64_t
+RingBuffer_TestNotifyPoll (int fd)
+{
+    struct pollfd pollFd;
+    uint64_t      value;
+    ssize_t       res;
+
+    pollFd.fd      = fd;
+    pollFd.events  = POLLIN;
+    pollFd.revents = 0;
+    value          = 0U;
+
+    if ((poll (&pollFd, 1U, 0) == 1) && ((pollFd.revents & POLLIN) != 0))
+    {
+        res = read (fd, &value, sizeof (value));
+
+        assert (res == (ssize_t) sizeof (value));
+    }
+    else
+    {
+    }
+
+    return value;
+}
+#endif /* RING_BUFFER_NOTIFY == 1 */
+
+static void
+RingBuffer_TestNotify (void)
+{
+#if (RING_BUFFER_NOTIFY == 1)
+    uint32_t i;
+    uint32_t arg;
+    int32_t  empty;
+    int      fd;
+    uint64_t signals;
+    Item_t   item;
+
+    RingBuffer_Create (, Item_t, notifyBuffer, 16, RingBuffer_ProtectCallback, &arg);
+
+    fd = eventfd (0U, (EFD_NONBLOCK | EFD_CLOEXEC));
+
+    assert (fd >= 0);
+
+    RingBuffer_NotifyInit (notifyBuffer, fd);
+
+    (void) memset (&item, 0x00, sizeof (item));
+
+    assert (RingBuffer_TestNotifyPoll (fd) == 0U);
+
+    /* A burst of pushes costs a single signal. */
+    for (i = 0U; i < 5U; i++)
+    {
+        item.x = i;
+
+        RingBuffer_Push (notifyBuffer, item);
+    }
+
+    assert (RingBuffer_TestNotifyPoll (fd) == 1U);
+
+    item.x = 5U;
+
+    RingBuffer_Push (notifyBuffer, item);
+
+    assert (RingBuffer_TestNotifyPoll (fd) == 0U);
+
+    /* Items racing in before re-arming keep the consumer popping. */
+    for (i = 0U; i < 3U; i++)
+    {
+        RingBuffer_Pop (notifyBuffer, item);
+
+        assert (item.x == i);
+    }
+
+    RingBuffer_NotifyRearm (notifyBuffer, empty);
+
+    assert (empty == 0);
+
+    while (RingBuffer_IsEmpty (notifyBuffer) == 0)
+    {
+        RingBuffer_Pop (notifyBuffer, item);
+    }
+
+    RingBuffer_NotifyRearm (notifyBuffer, empty);
+
+    assert ((empty == 1) && (item.x == 5U));
+
+    /* Empty -> non-empty again, through the bulk path. */
+    RingBuffer_Write (notifyBuffer, &item, 1U, 1, i);
+
+    signals = RingBuffer_TestNotifyPoll (fd);
+
+    (void) printf ("notify signals %"PRIu64"\n", signals);
+
+    assert ((i == 1U) && (signals == 1U));
+
+    (void) close (fd);
+#endif /* RING_BUFFER_NOTIFY == 1 */
+}
@@ -23,6 +23,97 @@
 /* Module configuration. */
 #include "RingBuffer_Conf.h"
 
+/* ***************************************************************************************************************** *
+ *                                             Configuration check section                                           *
+ * ***************************************************************************************************************** */
+
+#ifndef RING_BUFFER_PROTECT
+    #define RING_BUFFER_PROTECT 0
+#endif /* RING_BUFFER_PROTECT */
+
+#ifndef RING_BUFFER_SPSC
+    #define RING_BUFFER_SPSC 0
+#endif /* RING_BUFFER_SPSC */
+
+#ifndef RING_BUFFER_POW2
+    #define RING_BUFFER_POW2 0
+#endif /* RING_BUFFER_POW2 */
+
+#ifndef RING_BUFFER_CACHE_ALIGN
+    #define RING_BUFFER_CACHE_ALIGN 0
+#endif /* RING_BUFFER_CACHE_ALIGN */
+
+#ifndef RING_BUFFER_CACHE_LINE_SIZE
+    #define RING_BUFFER_CACHE_LINE_SIZE 64
+#endif /* RING_BUFFER_CACHE_LINE_SIZE */
+
+#ifndef RING_BUFFER_WAIT
+    #define RING_BUFFER_WAIT 0
+#endif /* RING_BUFFER_WAIT */
+
+#ifndef RING_BUFFER_WAIT_SPIN
+    #define RING_BUFFER_WAIT_SPIN 128
+#endif /* RING_BUFFER_WAIT_SPIN */
+
+#ifndef RING_BUFFER_NOTIFY
+    #define RING_BUFFER_NOTIFY 0
+#endif /* RING_BUFFER_NOTIFY */
+
+#ifndef RING_BUFFER_STATS
+    #define RING_BUFFER_STATS 0
+#endif /* RING_BUFFER_STATS */
+
+#ifndef RING_BUFFER_COPY_STREAM
+    #define RING_BUFFER_COPY_STREAM 0
+#endif /* RING_BUFFER_COPY_STREAM */
+
+#ifndef RING_BUFFER_COPY_THRESHOLD
+    #define RING_BUFFER_COPY_THRESHOLD 262144
+#endif /* RING_BUFFER_COPY_THRESHOLD */
+
+#if (RING_BUFFER_COPY_STREAM == 1) && (RING_BUFFER_COPY_THRESHOLD < 256)
+    #error "RING_BUFFER_COPY_THRESHOLD must be at least 256 bytes"
+#endif /* (RING_BUFFER_COPY_STREAM == 1) && (RING_BUFFER_COPY_THRESHOLD < 256) */
+
+#if (RING_BUFFER_SPSC == 1) && (RING_BUFFER_PROTECT == 1)
+    #error "RING_BUFFER_SPSC and RING_BUFFER_PROTECT are mutually exclusive"
+#endif /* (RING_BUFFER_SPSC == 1) && (RING_BUFFER_PROTECT == 1) */
+
+#if (RING_BUFFER_SPSC == 1) || (RING_BUFFER_WAIT == 1) || (RING_BUFFER_NOTIFY == 1)
+    /* Standard includes. */
+    #include <stdatomic.h>
+#endif /* (RING_BUFFER_SPSC == 1) || (RING_BUFFER_WAIT == 1) || (RING_BUFFER_NOTIFY == 1) */
+
+#if (RING_BUFFER_WAIT == 1)
+    /* Standard includes. */
+    #include <errno.h>
+    #include <limits.h>
+    #include <time.h>
+    /* System includes. */
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif /* RING_BUFFER_WAIT == 1 */
+
+#if (RING_BUFFER_NOTIFY == 1)
+    /* System includes. */
+    #include <unistd.h>
+#endif /* RING_BUFFER_NOTIFY == 1 */
+
+#if (RING_BUFFER_STATS == 1)
+    /* Standard includes. */
+    #include <time.h>
+#endif /* RING_BUFFER_STATS == 1 */
+
+#if (RING_BUFFER_COPY_STREAM == 1) && (defined (__x86_64__) || defined (__i386__)) && defined (__GNUC__)
+    /* Compiler includes. */
+    #include <immintrin.h>
+    /* Streaming kernels are built for each instruction set and selected at runtime. */
+    #define RING_BUFFER_COPY_X86 1
+#else
+    #define RING_BUFFER_COPY_X86 0
+#endif /* (RING_BUFFER_COPY_STREAM == 1) && (defined (__x86_64__) || defined (__i386__)) && defined (__GNUC__) */
+
 /* ***************************************************************************************************************** *
  *                                             Global definitions section                                            *
  * ***************************************************************************************************************** */
@@ -53,53 +144,338 @@
 #define RING_BUFFER_LOCK 1
 
 /**
- * Macro for creating a ring buffer.
+ * Ring buffer operation succeeded.
+ */
+#define RING_BUFFER_OK 0
+
+/**
+ * Ring buffer operation failed, ring buffer is full.
+ */
+#define RING_BUFFER_FULL 1
+
+/**
+ * Ring buffer operation failed, ring buffer is empty.
+ */
+#define RING_BUFFER_EMPTY 2
+
+/**
+ * Ring buffer operation still in progress (e.g. lost a race against another producer / consumer).
+ */
+#define RING_BUFFER_BUSY 3
+
+/**
+ * Ring buffer operation failed (e.g. system call error).
+ */
+#define RING_BUFFER_ERROR 4
+
+/**
+ * Full ring buffer policy: the oldest items are overwritten (the new ones are dropped if \ref RING_BUFFER_SPSC is
+ * enabled, since the tail is owned by the consumer).
+ */
+#define RING_BUFFER_OVERWRITE 0
+
+/**
+ * Full ring buffer policy: items that do not fit are rejected, nothing is recorded.
+ */
+#define RING_BUFFER_REJECT 1
+
+/**
+ * Full ring buffer policy: items that do not fit are dropped and counted (see \ref RingBuffer_GetDropped).
+ */
+#define RING_BUFFER_DROP 2
+
+/**
+ * Full ring buffer policy: the producer waits until items fit (futex wait if \ref RING_BUFFER_WAIT is enabled,
+ * busy-wait otherwise).
+ */
+#define RING_BUFFER_BLOCK 3
+
+/**
+ * Infinite timeout for blocking operations (if \ref RING_BUFFER_WAIT is enabled).
+ */
+#define RING_BUFFER_WAIT_FOREVER UINT32_MAX
+
+/**
+ * Macro for declaring the anonymous ring buffer type (e.g. to embed ring buffers into arrays or other structs).
  *
- * @param          storageClass Storage class for the ring buffer (e.g. static).
- * @param          type         Type of ring buffer elements (e.g. uint8_t).
- * @param          name         Ring buffer name.
- * @param          pLength      Ring buffer length.
+ * @param type    Type of ring buffer elements (e.g. uint8_t).
+ * @param pLength Ring buffer length (must be a power of two if \ref RING_BUFFER_POW2 is enabled).
+ *
+ * @note If \ref RING_BUFFER_SPSC is enabled, head and tail are C11 atomics.
+ * @note If \ref RING_BUFFER_CACHE_ALIGN is enabled, head and tail lie on separate cache lines; the full ring buffer
+ *       policy and the dropped items counter, used by the producer only, share the head one.
+ * @note If \ref RING_BUFFER_WAIT is enabled, the number of blocked consumers / producers is tracked too, next to the
+ *       index read by the side waking them up.
+ * @note If \ref RING_BUFFER_NOTIFY is enabled, the readiness notifier fd and its armed flag are embedded.
+ * @note If \ref RING_BUFFER_STATS is enabled, statistics counters are embedded (see \ref RingBuffer_GetStats), split
+ *       like the waiter counters between the producer and the consumer side.
+ */
+#if (RING_BUFFER_PROTECT == 1)
+    #define RingBuffer_Type(pType, pLength)          \
+        struct                                       \
+        {                                            \
+            pType    array[(pLength)];               \
+            RingBuffer_LengthCheck ((pLength))       \
+            RingBuffer_CacheAligned uint32_t head;   \
+            uint8_t  fullPolicy;                     \
+            uint32_t dropped;                        \
+            RingBuffer_HeadWaitFields                \
+            RingBuffer_ProducerStatsFields           \
+            RingBuffer_CacheAligned uint32_t tail;   \
+            struct                                   \
+            {                                        \
+                void (*ptrCallback)(uint8_t, void*); \
+                void* ptrArg;                        \
+            } protect;                               \
+            RingBuffer_TailWaitFields                \
+            RingBuffer_ConsumerStatsFields           \
+            RingBuffer_NotifyFields                  \
+        }
+#elif (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Type(pType, pLength)                \
+        struct                                             \
+        {                                                  \
+            pType            array[(pLength)];             \
+            RingBuffer_LengthCheck ((pLength))             \
+            RingBuffer_CacheAligned _Atomic uint32_t head; \
+            RingBuffer_CachedIndex (tailCache)             \
+            uint8_t          fullPolicy;                   \
+            _Atomic uint32_t dropped;                      \
+            RingBuffer_HeadWaitFields                      \
+            RingBuffer_ProducerStatsFields                 \
+            RingBuffer_CacheAligned _Atomic uint32_t tail; \
+            RingBuffer_CachedIndex (headCache)             \
+            RingBuffer_TailWaitFields                      \
+            RingBuffer_ConsumerStatsFields                 \
+            RingBuffer_NotifyFields                        \
+        }
+#else
+    #define RingBuffer_Type(pType, pLength)        \
+        struct                                     \
+        {                                          \
+            pType    array[(pLength)];             \
+            RingBuffer_LengthCheck ((pLength))     \
+            RingBuffer_CacheAligned uint32_t head; \
+            uint8_t  fullPolicy;                   \
+            uint32_t dropped;                      \
+            RingBuffer_HeadWaitFields              \
+            RingBuffer_ProducerStatsFields         \
+            RingBuffer_CacheAligned uint32_t tail; \
+            RingBuffer_TailWaitFields              \
+            RingBuffer_ConsumerStatsFields         \
+            RingBuffer_NotifyFields                \
+        }
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+/**
+ * Macro for the static initializer of a ring buffer declared w/ \ref RingBuffer_Type.
+ *
+ * @param          pPolicy      Full ring buffer policy (\ref RING_BUFFER_OVERWRITE, \ref RING_BUFFER_REJECT,
+ *                              \ref RING_BUFFER_DROP or \ref RING_BUFFER_BLOCK).
  * @param[in]      pPtrCallback Protect callback (\ref RING_BUFFER_PROTECT must be eanbled).
  * @param[in, out] pPtrArg      Protect callback pointer to argument (if \ref RING_BUFFER_PROTECT is enabled).
  */
 #if (RING_BUFFER_PROTECT == 1)
-    // cppcheck-suppress misra-c2012-20.7; no way to enclose pStorageClass / pName due to X-macro
-    #define RingBuffer_Create(pStorageClass, pType, pName, pLength, pPtrCallback, pPtrArg) \
-        pStorageClass struct                                                               \
-        {                                                                                  \
-            pType    array[(pLength)];                                                     \
-            uint32_t head;                                                                 \
-            uint32_t tail;                                                                 \
-            struct                                                                         \
-            {                                                                              \
-                void (*ptrCallback)(uint8_t, void*);                                       \
-                void* ptrArg;                                                              \
-            } protect;                                                                     \
-        } pName =                                                                          \
-        {                                                                                  \
-            .head    = 0,                                                                  \
-            .tail    = 0,                                                                  \
-            .protect =                                                                     \
-            {                                                                              \
-                .ptrCallback = (pPtrCallback),                                             \
-                .ptrArg      = (pPtrArg)                                                   \
-            }                                                                              \
+    #define RingBuffer_Initializer(pPolicy, pPtrCallback, pPtrArg) \
+        {                                                          \
+            .head       = 0,                                       \
+            .tail       = 0,                                       \
+            .fullPolicy = (pPolicy),                               \
+            .dropped    = 0,                                       \
+            .protect    =                                          \
+            {                                                      \
+                .ptrCallback = (pPtrCallback),                     \
+                .ptrArg      = (pPtrArg)                           \
+            }                                                      \
         }
 #else
-    // cppcheck-suppress misra-c2012-20.7; no way to enclose pStorageClass / pName due to X-macro
-    #define RingBuffer_Create(pStorageClass, pType, pName, pLength, ...) \
-        pStorageClass struct                                             \
-        {                                                                \
-            pType    array[(pLength)];                                   \
-            uint32_t head;                                               \
-            uint32_t tail;                                               \
-        } pName =                                                        \
-        {                                                                \
-            .head = 0,                                                   \
-            .tail = 0                                                    \
+    #define RingBuffer_Initializer(pPolicy, ...) \
+        {                                        \
+            .head       = 0,                     \
+            .tail       = 0,                     \
+            .fullPolicy = (pPolicy),             \
+            .dropped    = 0                      \
+        }
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+/**
+ * Initializes a ring buffer at runtime (e.g. ring buffers embedded into arrays, see \ref RingBuffer_Type).
+ *
+ * @param[in, out] pName        Ring buffer variable name.
+ * @param          pPolicy      Full ring buffer policy (\ref RING_BUFFER_OVERWRITE, \ref RING_BUFFER_REJECT,
+ *                              \ref RING_BUFFER_DROP or \ref RING_BUFFER_BLOCK).
+ * @param[in]      pPtrCallback Protect callback (\ref RING_BUFFER_PROTECT must be eanbled).
+ * @param[in, out] pPtrArg      Protect callback pointer to argument (if \ref RING_BUFFER_PROTECT is enabled).
+ *
+ * @note Must not be called while the ring buffer is in use.
+ */
+#if (RING_BUFFER_PROTECT == 1)
+    #define RingBuffer_Init(pName, pPolicy, pPtrCallback, pPtrArg) \
+        {                                                          \
+            (void) memset (&(pName), 0x00, sizeof ((pName)));      \
+            (pName).fullPolicy          = (pPolicy);               \
+            (pName).protect.ptrCallback = (pPtrCallback);          \
+            (pName).protect.ptrArg      = (pPtrArg);               \
+        }
+#else
+    #define RingBuffer_Init(pName, pPolicy, ...)              \
+        {                                                     \
+            (void) memset (&(pName), 0x00, sizeof ((pName))); \
+            (pName).fullPolicy = (pPolicy);                   \
         }
 #endif /* RING_BUFFER_PROTECT == 1 */
 
+/**
+ * Macro for creating a ring buffer w/ a given full ring buffer policy.
+ *
+ * @param          storageClass Storage class for the ring buffer (e.g. static).
+ * @param          type         Type of ring buffer elements (e.g. uint8_t).
+ * @param          name         Ring buffer name.
+ * @param          pLength      Ring buffer length (must be a power of two if \ref RING_BUFFER_POW2 is enabled).
+ * @param          pPolicy      Full ring buffer policy (\ref RING_BUFFER_OVERWRITE, \ref RING_BUFFER_REJECT,
+ *                              \ref RING_BUFFER_DROP or \ref RING_BUFFER_BLOCK).
+ * @param[in]      pPtrCallback Protect callback (\ref RING_BUFFER_PROTECT must be eanbled).
+ * @param[in, out] pPtrArg      Protect callback pointer to argument (if \ref RING_BUFFER_PROTECT is enabled).
+ *
+ * @note If \ref RING_BUFFER_SPSC is enabled, the protect arguments are ignored.
+ */
+// cppcheck-suppress misra-c2012-20.7; no way to enclose pStorageClass / pName due to X-macro
+#define RingBuffer_CreateWithPolicy(pStorageClass, pType, pName, pLength, pPolicy, ...) \
+    pStorageClass RingBuffer_Type (pType, (pLength)) pName = RingBuffer_Initializer ((pPolicy), __VA_ARGS__)
+
+/**
+ * Macro for creating a ring buffer w/ the \ref RING_BUFFER_OVERWRITE full ring buffer policy.
+ *
+ * @param          storageClass Storage class for the ring buffer (e.g. static).
+ * @param          type         Type of ring buffer elements (e.g. uint8_t).
+ * @param          name         Ring buffer name.
+ * @param          pLength      Ring buffer length (must be a power of two if \ref RING_BUFFER_POW2 is enabled).
+ * @param[in]      pPtrCallback Protect callback (\ref RING_BUFFER_PROTECT must be eanbled).
+ * @param[in, out] pPtrArg      Protect callback pointer to argument (if \ref RING_BUFFER_PROTECT is enabled).
+ */
+// cppcheck-suppress misra-c2012-20.7; no way to enclose pStorageClass / pName due to X-macro
+#define RingBuffer_Create(pStorageClass, pType, pName, pLength, ...) \
+    RingBuffer_CreateWithPolicy (pStorageClass, pType, pName, pLength, RING_BUFFER_OVERWRITE, __VA_ARGS__)
+
+/**
+ * Aligns a ring buffer index to its own cache line (if \ref RING_BUFFER_CACHE_ALIGN is enabled).
+ */
+#if (RING_BUFFER_CACHE_ALIGN == 1)
+    #define RingBuffer_CacheAligned \
+        _Alignas (RING_BUFFER_CACHE_LINE_SIZE)
+#else
+    #define RingBuffer_CacheAligned
+#endif /* RING_BUFFER_CACHE_ALIGN == 1 */
+
+/**
+ * Declares the local copy of the opposite index (if \ref RING_BUFFER_CACHE_ALIGN is enabled).
+ *
+ * @note The producer caches the tail next to the head, the consumer caches the head next to the tail: the shared
+ *       index is read again only when the cached one says full / empty.
+ *
+ * @param pIndex Cached index name.
+ */
+#if (RING_BUFFER_CACHE_ALIGN == 1)
+    #define RingBuffer_CachedIndex(pIndex) \
+        uint32_t pIndex;
+#else
+    #define RingBuffer_CachedIndex(pIndex)
+#endif /* RING_BUFFER_CACHE_ALIGN == 1 */
+
+/**
+ * Resets the local copies of the opposite indexes (if \ref RING_BUFFER_CACHE_ALIGN is enabled).
+ *
+ * @param pName Ring buffer variable name.
+ */
+#if (RING_BUFFER_CACHE_ALIGN == 1)
+    #define RingBuffer_ResetCachedIndexes(pName) \
+        (pName).tailCache = 0U;                  \
+        (pName).headCache = 0U
+#else
+    #define RingBuffer_ResetCachedIndexes(pName)
+#endif /* RING_BUFFER_CACHE_ALIGN == 1 */
+
+/**
+ * Declares the number of consumers blocked on head (if \ref RING_BUFFER_WAIT is enabled).
+ *
+ * @note Read by the producer on every push, written only when a consumer parks: it lies on the producer line.
+ */
+#if (RING_BUFFER_WAIT == 1)
+    #define RingBuffer_HeadWaitFields \
+        _Atomic uint32_t headWaiters;
+#else
+    #define RingBuffer_HeadWaitFields
+#endif /* RING_BUFFER_WAIT == 1 */
+
+/**
+ * Declares the number of producers blocked on tail (if \ref RING_BUFFER_WAIT is enabled).
+ *
+ * @note Read by the consumer on every pop, written only when a producer parks: it lies on the consumer line.
+ */
+#if (RING_BUFFER_WAIT == 1)
+    #define RingBuffer_TailWaitFields \
+        _Atomic uint32_t tailWaiters;
+#else
+    #define RingBuffer_TailWaitFields
+#endif /* RING_BUFFER_WAIT == 1 */
+
+/**
+ * Declares the readiness notifier eventfd and its armed flag (if \ref RING_BUFFER_NOTIFY is enabled).
+ */
+#if (RING_BUFFER_NOTIFY == 1)
+    #define RingBuffer_NotifyFields          \
+        int              notifyFd;           \
+        _Atomic uint32_t notifyArmed;
+#else
+    #define RingBuffer_NotifyFields
+#endif /* RING_BUFFER_NOTIFY == 1 */
+
+/**
+ * Declares the statistics counters updated by the producer (if \ref RING_BUFFER_STATS is enabled).
+ *
+ * @note The lock hold time is accounted by both sides, but only under the lock (\ref RING_BUFFER_PROTECT).
+ */
+#if (RING_BUFFER_STATS == 1)
+    #define RingBuffer_ProducerStatsFields         \
+        struct                                     \
+        {                                          \
+            RingBuffer_StatsCounter_t pushes;      \
+            RingBuffer_StatsCounter_t overwritten; \
+            RingBuffer_StatsCounter_t highWater;   \
+            uint64_t                  lockTime;    \
+            uint64_t                  lockTimeMax; \
+            uint64_t                  lockStart;   \
+        } producerStats;
+#else
+    #define RingBuffer_ProducerStatsFields
+#endif /* RING_BUFFER_STATS == 1 */
+
+/**
+ * Declares the statistics counters updated by the consumer (if \ref RING_BUFFER_STATS is enabled).
+ */
+#if (RING_BUFFER_STATS == 1)
+    #define RingBuffer_ConsumerStatsFields    \
+        struct                                \
+        {                                     \
+            RingBuffer_StatsCounter_t pops;   \
+        } consumerStats;
+#else
+    #define RingBuffer_ConsumerStatsFields
+#endif /* RING_BUFFER_STATS == 1 */
+
+/**
+ * Compile-time check of the ring buffer length (power of two if \ref RING_BUFFER_POW2 is enabled).
+ *
+ * @param pLength Ring buffer length.
+ */
+#if (RING_BUFFER_POW2 == 1)
+    #define RingBuffer_LengthCheck(pLength)                                      \
+        _Static_assert (((pLength) > 0) && (((pLength) & ((pLength) - 1)) == 0), \
+                        "RING_BUFFER_POW2 requires a power of two length");
+#else
+    #define RingBuffer_LengthCheck(pLength)
+#endif /* RING_BUFFER_POW2 == 1 */
+
 /**
  * Thread-safe protect callback (if \ref RING_BUFFER_PROTECT is enabled).
  *
@@ -117,15 +493,28 @@
 /**
  * Resets ring buffer indexes.
  *
+ * @warning If \ref RING_BUFFER_SPSC is enabled, neither the producer nor the consumer must be running.
+ *
  * @param pName Ring buffer variable name.
  */
-#define RingBuffer_Reset(pName)                                                                   \
-{                                                                                                 \
-    RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
-    (pName).head = 0;                                                                             \
-    (pName).tail = 0;                                                                             \
-    RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
-}
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Reset(pName)                                      \
+    {                                                                    \
+        atomic_store_explicit (&(pName).head, 0U, memory_order_relaxed); \
+        atomic_store_explicit (&(pName).tail, 0U, memory_order_relaxed); \
+        RingBuffer_ResetCachedIndexes ((pName));                         \
+    }
+#else
+    #define RingBuffer_Reset(pName)                                                                   \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        (pName).head = 0;                                                                             \
+        (pName).tail = 0;                                                                             \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
 
 /**
  * Gets the ring buffer type size.
@@ -147,6 +536,41 @@
 #define RingBuffer_GetLength(pName)                      \
     (sizeof ((pName).array) / sizeof ((pName).array[0]))
 
+/**
+ * Gets the number of slots that can be used at the same time.
+ *
+ * @note Unless \ref RING_BUFFER_POW2 is enabled, one slot is kept unused to tell full from empty.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The usable slots number of the ring buffer.
+ */
+#if (RING_BUFFER_POW2 == 1)
+    #define RingBuffer_GetCapacity(pName) \
+        RingBuffer_GetLength ((pName))
+#else
+    #define RingBuffer_GetCapacity(pName)        \
+        (RingBuffer_GetLength ((pName)) - 1UL)
+#endif /* RING_BUFFER_POW2 == 1 */
+
+/**
+ * Gets the array position of an index.
+ *
+ * @note If \ref RING_BUFFER_POW2 is enabled indexes are free-running, hence they are masked.
+ *
+ * @param pName  Ring buffer variable name.
+ * @param pIndex Head or tail index.
+ *
+ * @return The array position of the index.
+ */
+#if (RING_BUFFER_POW2 == 1)
+    #define RingBuffer_GetSlot(pName, pIndex)                                    \
+        ((uint32_t) ((pIndex) & (uint32_t) (RingBuffer_GetLength ((pName)) - 1UL)))
+#else
+    #define RingBuffer_GetSlot(pName, pIndex) \
+        (pIndex)
+#endif /* RING_BUFFER_POW2 == 1 */
+
 /**
  * @brief Increments index.
  *
@@ -154,8 +578,13 @@
  * @param pSize   Size to increment.
  * @param pLength Ring buffer length.
  */
-#define RingBuffer_IncrementLinear(pIndex, pSize, pLength)                                                   \
-    (pIndex) = (((pIndex) + (pSize)) >= (pLength)) ? ((pIndex) + (pSize) - (pLength)) : ((pIndex) + (pSize))
+#if (RING_BUFFER_POW2 == 1)
+    #define RingBuffer_IncrementLinear(pIndex, pSize, pLength) \
+        (pIndex) += (uint32_t) (pSize)
+#else
+    #define RingBuffer_IncrementLinear(pIndex, pSize, pLength)                                                   \
+        (pIndex) = (((pIndex) + (pSize)) >= (pLength)) ? ((pIndex) + (pSize) - (pLength)) : ((pIndex) + (pSize))
+#endif /* RING_BUFFER_POW2 == 1 */
 
 /**
  * @brief Increments the ring buffer tail index.
@@ -172,15 +601,27 @@
  * @param pName Ring buffer variable name.
  * @param pSize Size to increment.
  */
-#define RingBuffer_IncrementHead(pName, pSize)                                        \
-    RingBuffer_IncrementLinear((pName).head, (pSize), RingBuffer_GetLength((pName))); \
-    if ((pName).head == (pName).tail)                                                 \
-    {                                                                                 \
-        RingBuffer_IncrementTail((pName), 1U);                                        \
-    }                                                                                 \
-    else                                                                              \
-    {                                                                                 \
-    }
+#if (RING_BUFFER_POW2 == 1)
+    #define RingBuffer_IncrementHead(pName, pSize)                                        \
+        RingBuffer_IncrementLinear((pName).head, (pSize), RingBuffer_GetLength((pName))); \
+        if (((pName).head - (pName).tail) > RingBuffer_GetLength ((pName)))               \
+        {                                                                                 \
+            (pName).tail = (pName).head - (uint32_t) RingBuffer_GetLength ((pName));      \
+        }                                                                                 \
+        else                                                                              \
+        {                                                                                 \
+        }
+#else
+    #define RingBuffer_IncrementHead(pName, pSize)                                        \
+        RingBuffer_IncrementLinear((pName).head, (pSize), RingBuffer_GetLength((pName))); \
+        if ((pName).head == (pName).tail)                                                 \
+        {                                                                                 \
+            RingBuffer_IncrementTail((pName), 1U);                                        \
+        }                                                                                 \
+        else                                                                              \
+        {                                                                                 \
+        }
+#endif /* RING_BUFFER_POW2 == 1 */
 
 /**
  * Gets the number of the used slots in the ring buffer.
@@ -189,9 +630,19 @@
  *
  * @return The number of slots currently used.
  */
-#define RingBuffer_GetUsed(pName)                                                                                    \
-    ((uint32_t) (((pName).head >= (pName).tail) ? ((pName).head - (pName).tail)                                    : \
-                                                  (RingBuffer_GetLength ((pName)) - (pName).tail + (pName).head)))
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_GetUsed(pName)                                                    \
+        RingBuffer_Distance (atomic_load_explicit (&(pName).head, memory_order_acquire), \
+                             atomic_load_explicit (&(pName).tail, memory_order_acquire), \
+                             (uint32_t) RingBuffer_GetLength ((pName)))
+#elif (RING_BUFFER_POW2 == 1)
+    #define RingBuffer_GetUsed(pName)                  \
+        ((uint32_t) ((pName).head - (pName).tail))
+#else
+    #define RingBuffer_GetUsed(pName)                                                                            \
+        ((uint32_t) (((pName).head >= (pName).tail) ? ((pName).head - (pName).tail)                            : \
+                                                      (RingBuffer_GetLength ((pName)) - (pName).tail + (pName).head)))
+#endif /* RING_BUFFER_SPSC == 1 */
 
 /**
  * Gets the free slots in the buffer.
@@ -200,135 +651,1719 @@
  *
  * @return The number of slots currently available.
  */
-#define RingBuffer_GetFree(pName)                                             \
-    ((RingBuffer_GetLength ((pName)) - (RingBuffer_GetUsed ((pName)))) - 1UL)
+#define RingBuffer_GetFree(pName)                                      \
+    (RingBuffer_GetCapacity ((pName)) - (RingBuffer_GetUsed ((pName))))
 
 /**
- * Checks if the ring buffer is empty.
+ * Gets the number of used slots as seen by the producer (if \ref RING_BUFFER_SPSC is enabled).
  *
- * @param pName Ring buffer variable name.
+ * @param      pName   Ring buffer variable name.
+ * @param      pHead   Current head index.
+ * @param      pNeeded Number of free slots the producer needs.
+ * @param[out] pUsed   Number of used slots.
+ */
+#if (RING_BUFFER_CACHE_ALIGN == 1)
+    #define RingBuffer_GetProducerUsed(pName, pHead, pNeeded, pUsed)                                           \
+    {                                                                                                          \
+        (pUsed) = RingBuffer_Distance ((pHead), (pName).tailCache, (uint32_t) RingBuffer_GetLength ((pName))); \
+        if ((RingBuffer_GetCapacity ((pName)) - (pUsed)) < (pNeeded))                                          \
+        {                                                                                                      \
+            (pName).tailCache = atomic_load_explicit (&(pName).tail, memory_order_acquire);                    \
+            (pUsed)           = RingBuffer_Distance ((pHead),                                                  \
+                                                     (pName).tailCache,                                        \
+                                                     (uint32_t) RingBuffer_GetLength ((pName)));               \
+        }                                                                                                      \
+        else                                                                                                   \
+        {                                                                                                      \
+        }                                                                                                      \
+    }
+#else
+    #define RingBuffer_GetProducerUsed(pName, pHead, pNeeded, pUsed)                               \
+        (pUsed) = RingBuffer_Distance ((pHead),                                                    \
+                                       atomic_load_explicit (&(pName).tail, memory_order_acquire), \
+                                       (uint32_t) RingBuffer_GetLength ((pName)))
+#endif /* RING_BUFFER_CACHE_ALIGN == 1 */
+
+/**
+ * Gets the number of used slots as seen by the consumer (if \ref RING_BUFFER_SPSC is enabled).
  *
- * @return The ring buffer empty status (0-not empty, 1-empty).
+ * @param      pName   Ring buffer variable name.
+ * @param      pTail   Current tail index.
+ * @param      pNeeded Number of used slots the consumer needs.
+ * @param[out] pUsed   Number of used slots.
  */
-#define RingBuffer_IsEmpty(pName)         \
-    (RingBuffer_GetUsed ((pName)) == 0UL)
+#if (RING_BUFFER_CACHE_ALIGN == 1)
+    #define RingBuffer_GetConsumerUsed(pName, pTail, pNeeded, pUsed)                                           \
+    {                                                                                                          \
+        (pUsed) = RingBuffer_Distance ((pName).headCache, (pTail), (uint32_t) RingBuffer_GetLength ((pName))); \
+        if ((pUsed) < (pNeeded))                                                                               \
+        {                                                                                                      \
+            (pName).headCache = atomic_load_explicit (&(pName).head, memory_order_acquire);                    \
+            (pUsed)           = RingBuffer_Distance ((pName).headCache,                                        \
+                                                     (pTail),                                                  \
+                                                     (uint32_t) RingBuffer_GetLength ((pName)));               \
+        }                                                                                                      \
+        else                                                                                                   \
+        {                                                                                                      \
+        }                                                                                                      \
+    }
+#else
+    #define RingBuffer_GetConsumerUsed(pName, pTail, pNeeded, pUsed)                               \
+        (pUsed) = RingBuffer_Distance (atomic_load_explicit (&(pName).head, memory_order_acquire), \
+                                       (pTail),                                                    \
+                                       (uint32_t) RingBuffer_GetLength ((pName)))
+#endif /* RING_BUFFER_CACHE_ALIGN == 1 */
 
+#if (RING_BUFFER_STATS == 1)
 /**
- * Checks if the ring buffer is full.
+ * Time source for lock hold time statistics, in any monotonic unit (e.g. ns, CPU cycles, OS ticks).
+ */
+#ifndef RingBuffer_StatsClock
+    #define RingBuffer_StatsClock() \
+        RingBuffer_StatsMonotonic ()
+#endif /* RingBuffer_StatsClock */
+
+/**
+ * Reads / writes a statistics counter (relaxed atomics if \ref RING_BUFFER_SPSC is enabled, since producer and
+ * consumer counters are then updated by different threads).
+ *
+ * @param pCounter Statistics counter.
+ * @param pValue   Value to write / add.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_StatsLoad(pCounter) \
+        atomic_load_explicit (&(pCounter), memory_order_relaxed)
+    #define RingBuffer_StatsStore(pCounter, pValue) \
+        atomic_store_explicit (&(pCounter), (pValue), memory_order_relaxed)
+#else
+    #define RingBuffer_StatsLoad(pCounter) \
+        (pCounter)
+    #define RingBuffer_StatsStore(pCounter, pValue) \
+        ((pCounter) = (pValue))
+#endif /* RING_BUFFER_SPSC == 1 */
+
+#define RingBuffer_StatsAdd(pCounter, pValue)                                                    \
+    RingBuffer_StatsStore ((pCounter), (RingBuffer_StatsLoad ((pCounter)) + (uint64_t) (pValue)))
+
+/**
+ * Gets the number of used slots as seen by the producer, for the high-water mark.
+ *
+ * @note If \ref RING_BUFFER_SPSC and \ref RING_BUFFER_CACHE_ALIGN are enabled, the cached tail is used so that the
+ *       consumer line is not touched: the result is an upper bound of the used slots.
  *
  * @param pName Ring buffer variable name.
+ */
+#if (RING_BUFFER_SPSC == 1) && (RING_BUFFER_CACHE_ALIGN == 1)
+    #define RingBuffer_StatsUsed(pName)                                                  \
+        RingBuffer_Distance (atomic_load_explicit (&(pName).head, memory_order_relaxed), \
+                             (pName).tailCache,                                          \
+                             (uint32_t) RingBuffer_GetLength ((pName)))
+#elif (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_StatsUsed(pName)                                                  \
+        RingBuffer_Distance (atomic_load_explicit (&(pName).head, memory_order_relaxed), \
+                             atomic_load_explicit (&(pName).tail, memory_order_relaxed), \
+                             (uint32_t) RingBuffer_GetLength ((pName)))
+#else
+    #define RingBuffer_StatsUsed(pName) \
+        RingBuffer_GetUsed ((pName))
+#endif /* (RING_BUFFER_SPSC == 1) && (RING_BUFFER_CACHE_ALIGN == 1) */
+
+#endif /* RING_BUFFER_STATS == 1 */
+
+/**
+ * Accounts pushed items and updates the high-water mark (if \ref RING_BUFFER_STATS is enabled).
  *
- * @return The ring buffer full status (0-not full, 1-full).
+ * @param pName  Ring buffer variable name.
+ * @param pCount Number of pushed items.
  */
-#define RingBuffer_IsFull(pName)          \
-    (RingBuffer_GetFree ((pName)) == 0UL)
+#if (RING_BUFFER_STATS == 1)
+    #define RingBuffer_StatsPush(pName, pCount)                                 \
+    {                                                                           \
+        uint64_t statsUsed;                                                     \
+        statsUsed = RingBuffer_StatsUsed ((pName));                             \
+        RingBuffer_StatsAdd ((pName).producerStats.pushes, (pCount));           \
+        if (statsUsed > RingBuffer_StatsLoad ((pName).producerStats.highWater)) \
+        {                                                                       \
+            RingBuffer_StatsStore ((pName).producerStats.highWater, statsUsed); \
+        }                                                                       \
+        else                                                                    \
+        {                                                                       \
+        }                                                                       \
+    }
+#else
+    #define RingBuffer_StatsPush(pName, pCount)
+#endif /* RING_BUFFER_STATS == 1 */
 
 /**
- * Copies data from circular buffer to linear buffer w/o updating r/w indexes.
+ * Accounts popped and overwritten (oldest) items (if \ref RING_BUFFER_STATS is enabled).
  *
- * @param[out]     pPtrDest Linear buffer to copy data to.
- * @param[in, out] pSource  Ring buffer to copy data from.
- * @param          pSize    Number of slots to empty.
+ * @note Dropped (newest) items are only counted once, by \ref RingBuffer_Discard.
+ *
+ * @param pName  Ring buffer variable name.
+ * @param pCount Number of items.
  */
-#define RingBuffer_Empty(pPtrDest, pSource, pSize)                                                             \
-{                                                                                                              \
-    uint32_t used;                                                                                             \
-    uint32_t temp;                                                                                             \
-    uint32_t size;                                                                                             \
-    RingBuffer_Protect (RING_BUFFER_LOCK, (pSource).protect.ptrCallback, (pSource).protect.ptrArg);            \
-    used = RingBuffer_GetUsed ((pSource));                                                                     \
-    RingBuffer_Assert ((pSize) <= used);                                                                       \
-    if ((pSize) > used)                                                                                        \
-    {                                                                                                          \
-        size = used;                                                                                           \
-    }                                                                                                          \
-    else                                                                                                       \
-    {                                                                                                          \
-        size = (pSize);                                                                                        \
-    }                                                                                                          \
-    if (size >= (RingBuffer_GetLength ((pSource)) - (pSource).tail))                                           \
-    {                                                                                                          \
-        temp = (RingBuffer_GetLength ((pSource)) - (pSource).tail);                                            \
-    }                                                                                                          \
-    else                                                                                                       \
-    {                                                                                                          \
-        temp = size;                                                                                           \
-    }                                                                                                          \
-    (void) memcpy ((pPtrDest), &(pSource).array[(pSource).tail], (temp * RingBuffer_GetTypeSize ((pSource)))); \
-    (void) memcpy (&((uint8_t*) (pPtrDest))[(temp * RingBuffer_GetTypeSize ((pSource)))],                      \
-                   ((uint8_t*) (pSource).array),                                                                            \
-                   (size - temp) * RingBuffer_GetTypeSize ((pSource)));                                        \
-    RingBuffer_IncrementTail ((pSource), (pSize));                                                             \
-    RingBuffer_Protect (RING_BUFFER_UNLOCK, (pSource).protect.ptrCallback, (pSource).protect.ptrArg);          \
-}
+#if (RING_BUFFER_STATS == 1)
+    #define RingBuffer_StatsPop(pName, pCount) \
+        RingBuffer_StatsAdd ((pName).consumerStats.pops, (pCount))
+    #define RingBuffer_StatsOverwrite(pName, pCount) \
+        RingBuffer_StatsAdd ((pName).producerStats.overwritten, (pCount))
+#else
+    #define RingBuffer_StatsPop(pName, pCount)
+    #define RingBuffer_StatsOverwrite(pName, pCount)
+#endif /* RING_BUFFER_STATS == 1 */
+
+/**
+ * Accounts the time elapsed between lock and unlock (if \ref RING_BUFFER_STATS and \ref RING_BUFFER_PROTECT are
+ * enabled).
+ *
+ * @param pName Ring buffer variable name.
+ */
+#if (RING_BUFFER_STATS == 1) && (RING_BUFFER_PROTECT == 1)
+    #define RingBuffer_StatsLocked(pName) \
+        ((pName).producerStats.lockStart = RingBuffer_StatsClock ())
+    #define RingBuffer_StatsUnlocking(pName)                                                          \
+    {                                                                                                 \
+        uint64_t statsHeld;                                                                           \
+        statsHeld                       = RingBuffer_StatsClock () - (pName).producerStats.lockStart; \
+        (pName).producerStats.lockTime += statsHeld;                                                  \
+        if (statsHeld > (pName).producerStats.lockTimeMax)                                            \
+        {                                                                                             \
+            (pName).producerStats.lockTimeMax = statsHeld;                                            \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+        }                                                                                             \
+    }
+#else
+    #define RingBuffer_StatsLocked(pName)
+    #define RingBuffer_StatsUnlocking(pName)
+#endif /* (RING_BUFFER_STATS == 1) && (RING_BUFFER_PROTECT == 1) */
 
 /**
- * Pushes single item into ring buffer.
+ * Reads head or tail index.
  *
- * @warning In case ring buffer is full, oldest data is discarded.
+ * @param pIndex Head or tail index.
  *
- * @param pName Ring buffer to push to.
- * @param pItem Item to push.
+ * @return The index value.
  */
-#define RingBuffer_Push(pName, pItem)                                                             \
-{                                                                                                 \
-    RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
-    (pName).array[(pName).head] = (pItem);                                                        \
-    RingBuffer_IncrementHead ((pName), 1UL);                                                      \
-    RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
-}
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_GetIndex(pIndex)                          \
+        atomic_load_explicit (&(pIndex), memory_order_acquire)
+#else
+    #define RingBuffer_GetIndex(pIndex) \
+        (pIndex)
+#endif /* RING_BUFFER_SPSC == 1 */
 
 /**
- * Pops single item from ring buffer.
- * *
- * @param pName Ring buffer to push to.
- * @param pItem Item to copy to the popped item.
+ * Wakes the consumers blocked on head, if any (if \ref RING_BUFFER_WAIT is enabled), and signals the readiness
+ * notifier (if \ref RING_BUFFER_NOTIFY is enabled).
+ *
+ * @param pName Ring buffer variable name.
  */
-#define RingBuffer_Pop(pName, pItem)                                                              \
-{                                                                                                 \
-    RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
-    RingBuffer_Assert (RingBuffer_IsEmpty ((pName)) == 0UL);                                      \
-    (pItem) = (pName).array[(pName).tail];                                                        \
-    RingBuffer_IncrementTail ((pName), 1UL);                                                      \
-    RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
-}
+#if (RING_BUFFER_WAIT == 1) || (RING_BUFFER_NOTIFY == 1)
+    #define RingBuffer_WakeConsumers(pName)         \
+    {                                               \
+        atomic_thread_fence (memory_order_seq_cst); \
+        RingBuffer_WakeHeadWaiters ((pName));       \
+        RingBuffer_Notify ((pName));                \
+    }
+#else
+    #define RingBuffer_WakeConsumers(pName)
+#endif /* (RING_BUFFER_WAIT == 1) || (RING_BUFFER_NOTIFY == 1) */
 
 /**
- * Copies data from linear buffer to circular buffer.
+ * Wakes the consumers parked on head, if any (if \ref RING_BUFFER_WAIT is enabled).
  *
- * @param     pDest      Ring buffer to push to.
- * @param[in] pPtrSource Linear buffer to copy data from.
- * @param     pSize      Number of slots to fill.
+ * @note Must follow a sequentially consistent fence (see \ref RingBuffer_WakeConsumers).
+ *
+ * @param pName Ring buffer variable name.
  */
-#define RingBuffer_Fill(pDest, pPtrSource, pSize)                                                  \
-{                                                                                                  \
-    uint32_t size;                                                                                 \
-    RingBuffer_Assert ((pSize) < (RingBuffer_GetLength ((pDest)) - 1UL));                          \
-    RingBuffer_Protect (RING_BUFFER_LOCK, (pDest).protect.ptrCallback, (pDest).protect.ptrArg);    \
-    if ((pSize) >= (RingBuffer_GetLength ((pDest)) - (pDest).head))                                \
-    {                                                                                              \
-        size = (RingBuffer_GetLength ((pDest)) - (pDest).head);                                    \
-    }                                                                                              \
-    else                                                                                           \
-    {                                                                                              \
-        size = (pSize);                                                                            \
-    }                                                                                              \
-    (void) memcpy (&(pDest).array[((pDest).head * RingBuffer_GetTypeSize ((pDest)))], \
-                   (pPtrSource),                                                                   \
-                   (size * RingBuffer_GetTypeSize ((pDest))));                                     \
-    (void) memcpy (((uint8_t*) (pDest).array),                                                     \
-                   &((uint8_t*) (pPtrSource))[(size * RingBuffer_GetTypeSize ((pDest)))],          \
-                   (((pSize) - size) * RingBuffer_GetTypeSize ((pDest))));                         \
-    RingBuffer_IncrementHead ((pDest), (pSize));                                                   \
-    RingBuffer_Protect (RING_BUFFER_UNLOCK, (pDest).protect.ptrCallback, (pDest).protect.ptrArg);  \
-}
+#if (RING_BUFFER_WAIT == 1)
+    #define RingBuffer_WakeHeadWaiters(pName)                                        \
+    {                                                                                \
+        if (atomic_load_explicit (&(pName).headWaiters, memory_order_relaxed) != 0U) \
+        {                                                                            \
+            RingBuffer_FutexWake (&(pName).head);                                    \
+        }                                                                            \
+        else                                                                         \
+        {                                                                            \
+        }                                                                            \
+    }
+#else
+    #define RingBuffer_WakeHeadWaiters(pName)
+#endif /* RING_BUFFER_WAIT == 1 */
 
-/* ***************************************************************************************************************** *
- *                                              Global variables section                                             *
- * ***************************************************************************************************************** */
+/**
+ * Signals the readiness notifier if armed, i.e. on the first push after the consumer drained the ring buffer (if
+ * \ref RING_BUFFER_NOTIFY is enabled).
+ *
+ * @note Must follow a sequentially consistent fence (see \ref RingBuffer_WakeConsumers). Disarming is an exchange, so
+ *       a burst of pushes costs a single eventfd write until \ref RingBuffer_NotifyRearm.
+ *
+ * @param pName Ring buffer variable name.
+ */
+#if (RING_BUFFER_NOTIFY == 1)
+    #define RingBuffer_Notify(pName)                                                           \
+    {                                                                                          \
+        if ((atomic_load_explicit (&(pName).notifyArmed, memory_order_relaxed) != 0U) &&       \
+            (atomic_exchange_explicit (&(pName).notifyArmed, 0U, memory_order_acq_rel) != 0U)) \
+        {                                                                                      \
+            RingBuffer_NotifySignal ((pName).notifyFd);                                        \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+        }                                                                                      \
+    }
+#else
+    #define RingBuffer_Notify(pName)
+#endif /* RING_BUFFER_NOTIFY == 1 */
 
-/* ***************************************************************************************************************** *
- *                                              Global functions section                                             *
- * ***************************************************************************************************************** */
+/**
+ * Wakes the producers blocked on tail, if any (if \ref RING_BUFFER_WAIT is enabled).
+ *
+ * @param pName Ring buffer variable name.
+ */
+#if (RING_BUFFER_WAIT == 1)
+    #define RingBuffer_WakeProducers(pName)                                          \
+    {                                                                                \
+        atomic_thread_fence (memory_order_seq_cst);                                  \
+        if (atomic_load_explicit (&(pName).tailWaiters, memory_order_relaxed) != 0U) \
+        {                                                                            \
+            RingBuffer_FutexWake (&(pName).tail);                                    \
+        }                                                                            \
+        else                                                                         \
+        {                                                                            \
+        }                                                                            \
+    }
+#else
+    #define RingBuffer_WakeProducers(pName)
+#endif /* RING_BUFFER_WAIT == 1 */
+
+/**
+ * Checks if the ring buffer is empty.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The ring buffer empty status (0-not empty, 1-empty).
+ */
+#define RingBuffer_IsEmpty(pName)         \
+    (RingBuffer_GetUsed ((pName)) == 0UL)
+
+/**
+ * Checks if the ring buffer is full.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The ring buffer full status (0-not full, 1-full).
+ */
+#define RingBuffer_IsFull(pName)          \
+    (RingBuffer_GetFree ((pName)) == 0UL)
+
+/**
+ * Gets the number of items dropped by the \ref RING_BUFFER_DROP full ring buffer policy (and by
+ * \ref RING_BUFFER_OVERWRITE if \ref RING_BUFFER_SPSC is enabled).
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The number of dropped items (wraps around).
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_GetDropped(pName) \
+        atomic_load_explicit (&(pName).dropped, memory_order_relaxed)
+#else
+    #define RingBuffer_GetDropped(pName) \
+        (pName).dropped
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Accounts items that do not fit, unless the full ring buffer policy is \ref RING_BUFFER_REJECT.
+ *
+ * @note The counter is only written by the producer (under the lock, unless \ref RING_BUFFER_SPSC is enabled).
+ *
+ * @param pName  Ring buffer variable name.
+ * @param pCount Number of items.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Discard(pName, pCount)                                                       \
+    {                                                                                               \
+        if ((pName).fullPolicy != RING_BUFFER_REJECT)                                               \
+        {                                                                                           \
+            atomic_store_explicit (&(pName).dropped,                                                \
+                                   (atomic_load_explicit (&(pName).dropped, memory_order_relaxed) + \
+                                    (uint32_t) (pCount)),                                           \
+                                   memory_order_relaxed);                                           \
+        }                                                                                           \
+        else                                                                                        \
+        {                                                                                           \
+        }                                                                                           \
+    }
+#else
+    #define RingBuffer_Discard(pName, pCount)         \
+    {                                                 \
+        if ((pName).fullPolicy != RING_BUFFER_REJECT) \
+        {                                             \
+            (pName).dropped += (uint32_t) (pCount);   \
+        }                                             \
+        else                                          \
+        {                                             \
+        }                                             \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Waits for the ring buffer to be no longer full, on behalf of the \ref RING_BUFFER_BLOCK full ring buffer policy.
+ *
+ * @note Parks on the tail futex if \ref RING_BUFFER_WAIT is enabled, busy-waits otherwise.
+ *
+ * @param pName Ring buffer variable name.
+ */
+#if (RING_BUFFER_WAIT == 1)
+    #define RingBuffer_Block(pName)                            \
+    {                                                          \
+        int32_t blockTimedOut;                                 \
+        RingBuffer_WaitNotFull ((pName), NULL, blockTimedOut); \
+        (void) blockTimedOut;                                  \
+    }
+#else
+    #define RingBuffer_Block(pName) \
+        RingBuffer_CpuRelax ()
+#endif /* RING_BUFFER_WAIT == 1 */
+
+/**
+ * Pushes single item into ring buffer, applying the full ring buffer policy.
+ *
+ * @note If ring buffer is full: \ref RING_BUFFER_OVERWRITE discards the oldest item (the pushed one if
+ *       \ref RING_BUFFER_SPSC is enabled, since the tail is owned by the consumer), \ref RING_BUFFER_REJECT and
+ *       \ref RING_BUFFER_DROP discard the pushed item (the latter counts it) and \ref RING_BUFFER_BLOCK waits.
+ *
+ * @param      pName  Ring buffer to push to.
+ * @param      pItem  Item to push.
+ * @param[out] pCount Number of items accepted (either 1 or 0).
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_PushCount(pName, pItem, pCount)                                      \
+    {                                                                                       \
+        int32_t pushStatus;                                                                 \
+        RingBuffer_TryPush ((pName), (pItem), pushStatus);                                  \
+        while ((pushStatus != RING_BUFFER_OK) && ((pName).fullPolicy == RING_BUFFER_BLOCK)) \
+        {                                                                                   \
+            RingBuffer_Block ((pName));                                                     \
+            RingBuffer_TryPush ((pName), (pItem), pushStatus);                              \
+        }                                                                                   \
+        (pCount) = (pushStatus == RING_BUFFER_OK) ? 1UL : 0UL;                              \
+        if ((pCount) == 0UL)                                                                \
+        {                                                                                   \
+            RingBuffer_Discard ((pName), 1UL);                                              \
+        }                                                                                   \
+        else                                                                                \
+        {                                                                                   \
+        }                                                                                   \
+    }
+#else
+    #define RingBuffer_PushCount(pName, pItem, pCount)                                                \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        if ((RingBuffer_IsFull ((pName)) == 0) || ((pName).fullPolicy == RING_BUFFER_OVERWRITE))      \
+        {                                                                                             \
+            (pName).array[RingBuffer_GetSlot ((pName), (pName).head)] = (pItem);                      \
+            RingBuffer_StatsOverwrite ((pName), RingBuffer_IsFull ((pName)));                         \
+            RingBuffer_IncrementHead ((pName), 1UL);                                                  \
+            RingBuffer_StatsPush ((pName), 1UL);                                                      \
+            (pCount) = 1UL;                                                                           \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            (pCount) = 0UL;                                                                           \
+        }                                                                                             \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        if ((pCount) != 0UL)                                                                          \
+        {                                                                                             \
+            RingBuffer_WakeConsumers ((pName));                                                       \
+        }                                                                                             \
+        else if ((pName).fullPolicy == RING_BUFFER_BLOCK)                                             \
+        {                                                                                             \
+            int32_t pushStatus;                                                                       \
+            do                                                                                        \
+            {                                                                                         \
+                RingBuffer_Block ((pName));                                                           \
+                RingBuffer_TryPush ((pName), (pItem), pushStatus);                                    \
+            } while (pushStatus != RING_BUFFER_OK);                                                   \
+            (pCount) = 1UL;                                                                           \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            RingBuffer_Discard ((pName), 1UL);                                                        \
+        }                                                                                             \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Pushes single item into ring buffer, applying the full ring buffer policy (see \ref RingBuffer_PushCount).
+ *
+ * @warning With the default \ref RING_BUFFER_OVERWRITE policy, in case ring buffer is full, oldest data is discarded.
+ *          If \ref RING_BUFFER_SPSC is enabled the tail is owned by the consumer, hence the pushed item is discarded
+ *          instead.
+ *
+ * @param pName Ring buffer to push to.
+ * @param pItem Item to push.
+ */
+#define RingBuffer_Push(pName, pItem)                   \
+{                                                       \
+    uint32_t pushCount;                                 \
+    RingBuffer_PushCount ((pName), (pItem), pushCount); \
+    (void) pushCount;                                   \
+}
+
+/**
+ * Pops single item from ring buffer.
+ * *
+ * @param pName Ring buffer to push to.
+ * @param pItem Item to copy to the popped item.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Pop(pName, pItem)              \
+    {                                                 \
+        int32_t status;                               \
+        RingBuffer_TryPop ((pName), (pItem), status); \
+        RingBuffer_Assert (status == RING_BUFFER_OK); \
+        (void) status;                                \
+    }
+#else
+    #define RingBuffer_Pop(pName, pItem)                                                              \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        RingBuffer_Assert (RingBuffer_IsEmpty ((pName)) == 0UL);                                      \
+        (pItem) = (pName).array[RingBuffer_GetSlot ((pName), (pName).tail)];                          \
+        RingBuffer_IncrementTail ((pName), 1UL);                                                      \
+        RingBuffer_StatsPop ((pName), 1UL);                                                           \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        RingBuffer_WakeProducers ((pName));                                                           \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Tries to push single item into ring buffer.
+ *
+ * @note Full ring buffer is never overwritten.
+ *
+ * @param      pName   Ring buffer to push to.
+ * @param      pItem   Item to push.
+ * @param[out] pStatus \ref RING_BUFFER_OK if pushed, \ref RING_BUFFER_FULL if ring buffer is full.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_TryPush(pName, pItem, pStatus)                               \
+    {                                                                               \
+        uint32_t head;                                                              \
+        uint32_t used;                                                              \
+        head = atomic_load_explicit (&(pName).head, memory_order_relaxed);          \
+        RingBuffer_GetProducerUsed ((pName), head, 1UL, used);                      \
+        if (used < RingBuffer_GetCapacity ((pName)))                                \
+        {                                                                           \
+            (pName).array[RingBuffer_GetSlot ((pName), head)] = (pItem);            \
+            RingBuffer_IncrementLinear (head, 1UL, RingBuffer_GetLength ((pName))); \
+            atomic_store_explicit (&(pName).head, head, memory_order_release);      \
+            RingBuffer_StatsPush ((pName), 1UL);                                    \
+            RingBuffer_WakeConsumers ((pName));                                     \
+            (pStatus) = RING_BUFFER_OK;                                             \
+        }                                                                           \
+        else                                                                        \
+        {                                                                           \
+            (pStatus) = RING_BUFFER_FULL;                                           \
+        }                                                                           \
+    }
+#else
+    #define RingBuffer_TryPush(pName, pItem, pStatus)                                                 \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        if (RingBuffer_GetFree ((pName)) != 0UL)                                                      \
+        {                                                                                             \
+            (pName).array[RingBuffer_GetSlot ((pName), (pName).head)] = (pItem);                      \
+            RingBuffer_IncrementLinear ((pName).head, 1UL, RingBuffer_GetLength ((pName)));           \
+            RingBuffer_StatsPush ((pName), 1UL);                                                      \
+            (pStatus) = RING_BUFFER_OK;                                                               \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            (pStatus) = RING_BUFFER_FULL;                                                             \
+        }                                                                                             \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        if ((pStatus) == RING_BUFFER_OK)                                                              \
+        {                                                                                             \
+            RingBuffer_WakeConsumers ((pName));                                                       \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+        }                                                                                             \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Tries to pop single item from ring buffer.
+ *
+ * @param      pName   Ring buffer to pop from.
+ * @param      pItem   Item to copy to the popped item.
+ * @param[out] pStatus \ref RING_BUFFER_OK if popped, \ref RING_BUFFER_EMPTY if ring buffer is empty.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_TryPop(pName, pItem, pStatus)                                \
+    {                                                                               \
+        uint32_t tail;                                                              \
+        uint32_t used;                                                              \
+        tail = atomic_load_explicit (&(pName).tail, memory_order_relaxed);          \
+        RingBuffer_GetConsumerUsed ((pName), tail, 1UL, used);                      \
+        if (used != 0UL)                                                            \
+        {                                                                           \
+            (pItem) = (pName).array[RingBuffer_GetSlot ((pName), tail)];            \
+            RingBuffer_IncrementLinear (tail, 1UL, RingBuffer_GetLength ((pName))); \
+            atomic_store_explicit (&(pName).tail, tail, memory_order_release);      \
+            RingBuffer_StatsPop ((pName), 1UL);                                     \
+            RingBuffer_WakeProducers ((pName));                                     \
+            (pStatus) = RING_BUFFER_OK;                                             \
+        }                                                                           \
+        else                                                                        \
+        {                                                                           \
+            (pStatus) = RING_BUFFER_EMPTY;                                          \
+        }                                                                           \
+    }
+#else
+    #define RingBuffer_TryPop(pName, pItem, pStatus)                                                  \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        if (RingBuffer_IsEmpty ((pName)) == 0)                                                        \
+        {                                                                                             \
+            (pItem) = (pName).array[RingBuffer_GetSlot ((pName), (pName).tail)];                      \
+            RingBuffer_IncrementTail ((pName), 1UL);                                                  \
+            RingBuffer_StatsPop ((pName), 1UL);                                                       \
+            (pStatus) = RING_BUFFER_OK;                                                               \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            (pStatus) = RING_BUFFER_EMPTY;                                                            \
+        }                                                                                             \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        if ((pStatus) == RING_BUFFER_OK)                                                              \
+        {                                                                                             \
+            RingBuffer_WakeProducers ((pName));                                                       \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+        }                                                                                             \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+#if (RING_BUFFER_WAIT == 1)
+/**
+ * Parks the caller on a futex keyed on tail while ring buffer is full (if \ref RING_BUFFER_WAIT is enabled).
+ *
+ * @note The condition is re-checked under the lock after the waiter is registered, so no wake-up can be lost.
+ *
+ * @param      pName        Ring buffer variable name.
+ * @param[in]  pPtrDeadline Absolute deadline (NULL to wait forever).
+ * @param[out] pTimedOut    1 if the deadline expired, 0 otherwise.
+ */
+    #define RingBuffer_WaitNotFull(pName, pPtrDeadline, pTimedOut)                                    \
+    {                                                                                                 \
+        uint32_t snapshot;                                                                            \
+        int32_t  full;                                                                                \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        (void) atomic_fetch_add_explicit (&(pName).tailWaiters, 1U, memory_order_seq_cst);            \
+        atomic_thread_fence (memory_order_seq_cst);                                                   \
+        snapshot = RingBuffer_GetIndex ((pName).tail);                                                \
+        full     = (RingBuffer_Distance (RingBuffer_GetIndex ((pName).head),                          \
+                                         snapshot,                                                    \
+                                         (uint32_t) RingBuffer_GetLength ((pName))) >=                \
+                    RingBuffer_GetCapacity ((pName)));                                                \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        if (full != 0)                                                                                \
+        {                                                                                             \
+            (pTimedOut) = RingBuffer_FutexWait (&(pName).tail, snapshot, (pPtrDeadline));             \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+        }                                                                                             \
+        (void) atomic_fetch_sub_explicit (&(pName).tailWaiters, 1U, memory_order_relaxed);            \
+    }
+
+/**
+ * Parks the caller on a futex keyed on head while ring buffer is empty (if \ref RING_BUFFER_WAIT is enabled).
+ *
+ * @note The condition is re-checked under the lock after the waiter is registered, so no wake-up can be lost.
+ *
+ * @param      pName        Ring buffer variable name.
+ * @param[in]  pPtrDeadline Absolute deadline (NULL to wait forever).
+ * @param[out] pTimedOut    1 if the deadline expired, 0 otherwise.
+ */
+    #define RingBuffer_WaitNotEmpty(pName, pPtrDeadline, pTimedOut)                                   \
+    {                                                                                                 \
+        uint32_t snapshot;                                                                            \
+        int32_t  empty;                                                                               \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        (void) atomic_fetch_add_explicit (&(pName).headWaiters, 1U, memory_order_seq_cst);            \
+        atomic_thread_fence (memory_order_seq_cst);                                                   \
+        snapshot = RingBuffer_GetIndex ((pName).head);                                                \
+        empty    = (snapshot == RingBuffer_GetIndex ((pName).tail));                                  \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        if (empty != 0)                                                                               \
+        {                                                                                             \
+            (pTimedOut) = RingBuffer_FutexWait (&(pName).head, snapshot, (pPtrDeadline));             \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+        }                                                                                             \
+        (void) atomic_fetch_sub_explicit (&(pName).headWaiters, 1U, memory_order_relaxed);            \
+    }
+
+/**
+ * Pushes single item into ring buffer, blocking while ring buffer is full (if \ref RING_BUFFER_WAIT is enabled).
+ *
+ * @note The producer spins \ref RING_BUFFER_WAIT_SPIN times, then parks on a futex keyed on tail.
+ *
+ * @param      pName    Ring buffer to push to.
+ * @param      pItem    Item to push.
+ * @param      pTimeout Timeout in milliseconds (\ref RING_BUFFER_WAIT_FOREVER to wait forever).
+ * @param[out] pStatus  \ref RING_BUFFER_OK if pushed, \ref RING_BUFFER_FULL if timed out.
+ */
+    #define RingBuffer_PushWait(pName, pItem, pTimeout, pStatus)         \
+    {                                                                    \
+        struct timespec        deadline;                                 \
+        const struct timespec* ptrDeadline;                              \
+        uint32_t               spin;                                     \
+        int32_t                timedOut;                                 \
+        ptrDeadline = RingBuffer_GetDeadline ((pTimeout), &deadline);    \
+        spin        = 0U;                                                \
+        timedOut    = 0;                                                 \
+        RingBuffer_TryPush ((pName), (pItem), (pStatus));                \
+        while (((pStatus) != RING_BUFFER_OK) && (timedOut == 0))         \
+        {                                                                \
+            if (spin < RING_BUFFER_WAIT_SPIN)                            \
+            {                                                            \
+                spin++;                                                  \
+                RingBuffer_CpuRelax ();                                  \
+            }                                                            \
+            else                                                         \
+            {                                                            \
+                RingBuffer_WaitNotFull ((pName), ptrDeadline, timedOut); \
+            }                                                            \
+            RingBuffer_TryPush ((pName), (pItem), (pStatus));            \
+        }                                                                \
+    }
+
+/**
+ * Pops single item from ring buffer, blocking while ring buffer is empty (if \ref RING_BUFFER_WAIT is enabled).
+ *
+ * @note The consumer spins \ref RING_BUFFER_WAIT_SPIN times, then parks on a futex keyed on head.
+ *
+ * @param      pName    Ring buffer to pop from.
+ * @param      pItem    Item to copy to the popped item.
+ * @param      pTimeout Timeout in milliseconds (\ref RING_BUFFER_WAIT_FOREVER to wait forever).
+ * @param[out] pStatus  \ref RING_BUFFER_OK if popped, \ref RING_BUFFER_EMPTY if timed out.
+ */
+    #define RingBuffer_PopWait(pName, pItem, pTimeout, pStatus)           \
+    {                                                                     \
+        struct timespec        deadline;                                  \
+        const struct timespec* ptrDeadline;                               \
+        uint32_t               spin;                                      \
+        int32_t                timedOut;                                  \
+        ptrDeadline = RingBuffer_GetDeadline ((pTimeout), &deadline);     \
+        spin        = 0U;                                                 \
+        timedOut    = 0;                                                  \
+        RingBuffer_TryPop ((pName), (pItem), (pStatus));                  \
+        while (((pStatus) != RING_BUFFER_OK) && (timedOut == 0))          \
+        {                                                                 \
+            if (spin < RING_BUFFER_WAIT_SPIN)                             \
+            {                                                             \
+                spin++;                                                   \
+                RingBuffer_CpuRelax ();                                   \
+            }                                                             \
+            else                                                          \
+            {                                                             \
+                RingBuffer_WaitNotEmpty ((pName), ptrDeadline, timedOut); \
+            }                                                             \
+            RingBuffer_TryPop ((pName), (pItem), (pStatus));              \
+        }                                                                 \
+    }
+#endif /* RING_BUFFER_WAIT == 1 */
+
+/**
+ * Copies the bytes of a bulk write into ring buffer slots: w/ non-temporal stores from
+ * \ref RING_BUFFER_COPY_THRESHOLD bytes on (if \ref RING_BUFFER_COPY_STREAM is enabled, see
+ * \ref RingBuffer_CopyStream), w/ memcpy otherwise.
+ *
+ * @note Copies out of the ring buffer always use memcpy: their destination is usually read right away by the caller,
+ *       so bypassing the cache would only turn those reads into misses.
+ *
+ * @param[out] pPtrDest   Destination.
+ * @param[in]  pPtrSource Source.
+ * @param      pSize      Number of bytes to copy.
+ */
+#if (RING_BUFFER_COPY_STREAM == 1)
+    #define RingBuffer_CopyBytes(pPtrDest, pPtrSource, pSize) \
+        RingBuffer_CopyStream ((pPtrDest), (pPtrSource), (pSize))
+#else
+    #define RingBuffer_CopyBytes(pPtrDest, pPtrSource, pSize) \
+        (void) memcpy ((pPtrDest), (pPtrSource), (pSize))
+#endif /* RING_BUFFER_COPY_STREAM == 1 */
+
+/**
+ * Copies items from linear buffer into ring buffer slots, wrapping at the end of the array (at most two copies).
+ *
+ * @param     pName      Ring buffer to copy to.
+ * @param     pSlot      Array position of the first slot.
+ * @param[in] pPtrSource Linear buffer to copy data from.
+ * @param     pSize      Number of slots to copy.
+ */
+#define RingBuffer_CopyIn(pName, pSlot, pPtrSource, pSize)                                                    \
+{                                                                                                             \
+    uint32_t first;                                                                                           \
+    if ((pSize) > (RingBuffer_GetLength ((pName)) - (pSlot)))                                                 \
+    {                                                                                                         \
+        first = (uint32_t) (RingBuffer_GetLength ((pName)) - (pSlot));                                        \
+    }                                                                                                         \
+    else                                                                                                      \
+    {                                                                                                         \
+        first = (pSize);                                                                                      \
+    }                                                                                                         \
+    RingBuffer_CopyBytes (&(pName).array[(pSlot)], (pPtrSource), (first * RingBuffer_GetTypeSize ((pName)))); \
+    RingBuffer_CopyBytes (&(pName).array[0],                                                                  \
+                          &((const uint8_t*) (pPtrSource))[(first * RingBuffer_GetTypeSize ((pName)))],       \
+                          (((pSize) - first) * RingBuffer_GetTypeSize ((pName))));                            \
+}
+
+/**
+ * Copies items from ring buffer slots into linear buffer, wrapping at the end of the array (at most two copies).
+ *
+ * @param[out] pPtrDest Linear buffer to copy data to.
+ * @param      pName    Ring buffer to copy from.
+ * @param      pSlot    Array position of the first slot.
+ * @param      pSize    Number of slots to copy.
+ */
+#define RingBuffer_CopyOut(pPtrDest, pName, pSlot, pSize)                                            \
+{                                                                                                    \
+    uint32_t first;                                                                                  \
+    if ((pSize) > (RingBuffer_GetLength ((pName)) - (pSlot)))                                        \
+    {                                                                                                \
+        first = (uint32_t) (RingBuffer_GetLength ((pName)) - (pSlot));                               \
+    }                                                                                                \
+    else                                                                                             \
+    {                                                                                                \
+        first = (pSize);                                                                             \
+    }                                                                                                \
+    (void) memcpy ((pPtrDest), &(pName).array[(pSlot)], (first * RingBuffer_GetTypeSize ((pName)))); \
+    (void) memcpy (&((uint8_t*) (pPtrDest))[(first * RingBuffer_GetTypeSize ((pName)))],             \
+                   &(pName).array[0],                                                                \
+                   (((pSize) - first) * RingBuffer_GetTypeSize ((pName))));                          \
+}
+
+/**
+ * Gets the number of slots a bulk operation transfers.
+ *
+ * @param pSize      Requested number of slots.
+ * @param pAvailable Number of slots available for the operation.
+ * @param pExact     1-all or nothing, 0-up to pSize.
+ *
+ * @return The number of slots to transfer.
+ */
+#define RingBuffer_GetBulkSize(pSize, pAvailable, pExact) \
+    ((uint32_t) (((pSize) <= (pAvailable)) ? (pSize) : (((pExact) != 0) ? 0UL : (pAvailable))))
+
+/**
+ * Copies up to pSize items from linear buffer into ring buffer, taking the lock once.
+ *
+ * @note Full ring buffer is never overwritten.
+ *
+ * @param      pName      Ring buffer to push to.
+ * @param[in]  pPtrSource Linear buffer to copy data from.
+ * @param      pSize      Number of items to push.
+ * @param      pExact     1-all or nothing, 0-up to pSize.
+ * @param[out] pCount     Number of items actually pushed.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Write(pName, pPtrSource, pSize, pExact, pCount)                                    \
+    {                                                                                                     \
+        uint32_t head;                                                                                    \
+        uint32_t used;                                                                                    \
+        head = atomic_load_explicit (&(pName).head, memory_order_relaxed);                                \
+        RingBuffer_GetProducerUsed ((pName), head, (pSize), used);                                        \
+        (pCount) = RingBuffer_GetBulkSize ((pSize), (RingBuffer_GetCapacity ((pName)) - used), (pExact)); \
+        RingBuffer_CopyIn ((pName), RingBuffer_GetSlot ((pName), head), (pPtrSource), (pCount));          \
+        RingBuffer_IncrementLinear (head, (pCount), RingBuffer_GetLength ((pName)));                      \
+        atomic_store_explicit (&(pName).head, head, memory_order_release);                                \
+        RingBuffer_StatsPush ((pName), (pCount));                                                         \
+        RingBuffer_WakeConsumers ((pName));                                                               \
+    }
+#else
+    #define RingBuffer_Write(pName, pPtrSource, pSize, pExact, pCount)                                   \
+    {                                                                                                    \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);      \
+        RingBuffer_StatsLocked ((pName));                                                                \
+        (pCount) = RingBuffer_GetBulkSize ((pSize), RingBuffer_GetFree ((pName)), (pExact));             \
+        RingBuffer_CopyIn ((pName), RingBuffer_GetSlot ((pName), (pName).head), (pPtrSource), (pCount)); \
+        RingBuffer_IncrementLinear ((pName).head, (pCount), RingBuffer_GetLength ((pName)));             \
+        RingBuffer_StatsPush ((pName), (pCount));                                                        \
+        RingBuffer_StatsUnlocking ((pName));                                                             \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);    \
+        RingBuffer_WakeConsumers ((pName));                                                              \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Copies up to pSize items from ring buffer into linear buffer, taking the lock once.
+ *
+ * @param[out] pPtrDest Linear buffer to copy data to.
+ * @param      pName    Ring buffer to pop from.
+ * @param      pSize    Number of items to pop.
+ * @param      pExact   1-all or nothing, 0-up to pSize.
+ * @param[out] pCount   Number of items actually popped.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Read(pPtrDest, pName, pSize, pExact, pCount)                             \
+    {                                                                                           \
+        uint32_t tail;                                                                          \
+        uint32_t used;                                                                          \
+        tail = atomic_load_explicit (&(pName).tail, memory_order_relaxed);                      \
+        RingBuffer_GetConsumerUsed ((pName), tail, (pSize), used);                              \
+        (pCount) = RingBuffer_GetBulkSize ((pSize), used, (pExact));                            \
+        RingBuffer_CopyOut ((pPtrDest), (pName), RingBuffer_GetSlot ((pName), tail), (pCount)); \
+        RingBuffer_IncrementLinear (tail, (pCount), RingBuffer_GetLength ((pName)));            \
+        atomic_store_explicit (&(pName).tail, tail, memory_order_release);                      \
+        RingBuffer_StatsPop ((pName), (pCount));                                                \
+        RingBuffer_WakeProducers ((pName));                                                     \
+    }
+#else
+    #define RingBuffer_Read(pPtrDest, pName, pSize, pExact, pCount)                                     \
+    {                                                                                                   \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);     \
+        RingBuffer_StatsLocked ((pName));                                                               \
+        (pCount) = RingBuffer_GetBulkSize ((pSize), RingBuffer_GetUsed ((pName)), (pExact));            \
+        RingBuffer_CopyOut ((pPtrDest), (pName), RingBuffer_GetSlot ((pName), (pName).tail), (pCount)); \
+        RingBuffer_IncrementTail ((pName), (pCount));                                                   \
+        RingBuffer_StatsPop ((pName), (pCount));                                                        \
+        RingBuffer_StatsUnlocking ((pName));                                                            \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_WakeProducers ((pName));                                                             \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Pushes up to pSize items into ring buffer.
+ *
+ * @param      pName      Ring buffer to push to.
+ * @param[in]  pPtrSource Linear buffer to copy data from.
+ * @param      pSize      Number of items to push.
+ * @param[out] pCount     Number of items actually pushed (less than pSize if ring buffer gets full).
+ */
+#define RingBuffer_PushBulk(pName, pPtrSource, pSize, pCount)     \
+    RingBuffer_Write ((pName), (pPtrSource), (pSize), 0U, (pCount))
+
+/**
+ * Pushes pSize items into ring buffer only if all of them fit.
+ *
+ * @param      pName      Ring buffer to push to.
+ * @param[in]  pPtrSource Linear buffer to copy data from.
+ * @param      pSize      Number of items to push.
+ * @param[out] pCount     Number of items actually pushed (either pSize or 0).
+ */
+#define RingBuffer_PushAll(pName, pPtrSource, pSize, pCount)      \
+    RingBuffer_Write ((pName), (pPtrSource), (pSize), 1U, (pCount))
+
+/**
+ * Pops up to pSize items from ring buffer.
+ *
+ * @param      pName    Ring buffer to pop from.
+ * @param[out] pPtrDest Linear buffer to copy data to.
+ * @param      pSize    Number of items to pop.
+ * @param[out] pCount   Number of items actually popped (less than pSize if ring buffer gets empty).
+ */
+#define RingBuffer_PopBulk(pName, pPtrDest, pSize, pCount)      \
+    RingBuffer_Read ((pPtrDest), (pName), (pSize), 0U, (pCount))
+
+/**
+ * Pops pSize items from ring buffer only if all of them are available.
+ *
+ * @param      pName    Ring buffer to pop from.
+ * @param[out] pPtrDest Linear buffer to copy data to.
+ * @param      pSize    Number of items to pop.
+ * @param[out] pCount   Number of items actually popped (either pSize or 0).
+ */
+#define RingBuffer_PopAll(pName, pPtrDest, pSize, pCount)       \
+    RingBuffer_Read ((pPtrDest), (pName), (pSize), 1U, (pCount))
+
+/**
+ * Copies data from circular buffer to linear buffer, advancing the tail index.
+ *
+ * @note Requesting more slots than used is asserted, available ones are copied anyway.
+ *
+ * @param[out]     pPtrDest Linear buffer to copy data to.
+ * @param[in, out] pSource  Ring buffer to copy data from.
+ * @param          pSize    Number of slots to empty.
+ */
+#define RingBuffer_Empty(pPtrDest, pSource, pSize)              \
+{                                                               \
+    uint32_t count;                                             \
+    RingBuffer_PopBulk ((pSource), (pPtrDest), (pSize), count); \
+    RingBuffer_Assert (count == (pSize));                       \
+    (void) count;                                               \
+}
+
+/**
+ * Copies data from linear buffer to circular buffer, advancing the head index and applying the full ring buffer
+ * policy.
+ *
+ * @note If the items do not fit: \ref RING_BUFFER_OVERWRITE discards the oldest ones (the newest pSize ones are kept
+ *       if pSize exceeds the capacity; the items that do not fit are discarded if \ref RING_BUFFER_SPSC is enabled),
+ *       \ref RING_BUFFER_REJECT pushes none of them, \ref RING_BUFFER_DROP pushes the ones that fit and counts the
+ *       others and \ref RING_BUFFER_BLOCK waits until all of them are pushed.
+ *
+ * @param      pDest      Ring buffer to push to.
+ * @param[in]  pPtrSource Linear buffer to copy data from.
+ * @param      pSize      Number of slots to fill.
+ * @param[out] pCount     Number of items accepted.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_FillCount(pDest, pPtrSource, pSize, pCount)                                               \
+    {                                                                                                            \
+        RingBuffer_Write ((pDest), (pPtrSource), (pSize), ((pDest).fullPolicy == RING_BUFFER_REJECT), (pCount)); \
+        RingBuffer_FillRemaining ((pDest), (pPtrSource), (pSize), (pCount));                                     \
+    }
+#else
+    #define RingBuffer_FillCount(pDest, pPtrSource, pSize, pCount)                                          \
+    {                                                                                                       \
+        uint32_t fillSkip;                                                                                  \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pDest).protect.ptrCallback, (pDest).protect.ptrArg);         \
+        RingBuffer_StatsLocked ((pDest));                                                                   \
+        fillSkip = 0UL;                                                                                     \
+        if ((pDest).fullPolicy == RING_BUFFER_OVERWRITE)                                                    \
+        {                                                                                                   \
+            if ((pSize) > RingBuffer_GetCapacity ((pDest)))                                                 \
+            {                                                                                               \
+                fillSkip = (uint32_t) ((pSize) - RingBuffer_GetCapacity ((pDest)));                         \
+            }                                                                                               \
+            else                                                                                            \
+            {                                                                                               \
+            }                                                                                               \
+            if (((pSize) - fillSkip) > RingBuffer_GetFree ((pDest)))                                        \
+            {                                                                                               \
+                RingBuffer_StatsOverwrite ((pDest), (((pSize) - fillSkip) - RingBuffer_GetFree ((pDest)))); \
+                RingBuffer_IncrementTail ((pDest), (((pSize) - fillSkip) - RingBuffer_GetFree ((pDest))));  \
+            }                                                                                               \
+            else                                                                                            \
+            {                                                                                               \
+            }                                                                                               \
+            RingBuffer_StatsOverwrite ((pDest), fillSkip);                                                  \
+            (pCount) = (pSize);                                                                             \
+        }                                                                                                   \
+        else                                                                                                \
+        {                                                                                                   \
+            (pCount) = RingBuffer_GetBulkSize ((pSize),                                                     \
+                                               RingBuffer_GetFree ((pDest)),                                \
+                                               ((pDest).fullPolicy == RING_BUFFER_REJECT));                 \
+        }                                                                                                   \
+        RingBuffer_CopyIn ((pDest),                                                                         \
+                           RingBuffer_GetSlot ((pDest), (pDest).head),                                      \
+                           &((const uint8_t*) (pPtrSource))[fillSkip * RingBuffer_GetTypeSize ((pDest))],   \
+                           ((pCount) - fillSkip));                                                          \
+        RingBuffer_IncrementLinear ((pDest).head, ((pCount) - fillSkip), RingBuffer_GetLength ((pDest)));   \
+        RingBuffer_StatsPush ((pDest), (pCount));                                                           \
+        RingBuffer_StatsUnlocking ((pDest));                                                                \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pDest).protect.ptrCallback, (pDest).protect.ptrArg);       \
+        RingBuffer_WakeConsumers ((pDest));                                                                 \
+        RingBuffer_FillRemaining ((pDest), (pPtrSource), (pSize), (pCount));                                \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Handles the items a fill did not push: waits and pushes them if the full ring buffer policy is
+ * \ref RING_BUFFER_BLOCK, discards them otherwise.
+ *
+ * @param         pDest      Ring buffer to push to.
+ * @param[in]     pPtrSource Linear buffer to copy data from.
+ * @param         pSize      Number of slots to fill.
+ * @param[in,out] pCount     Number of items accepted so far.
+ */
+#define RingBuffer_FillRemaining(pDest, pPtrSource, pSize, pCount)                                       \
+{                                                                                                        \
+    uint32_t fillMore;                                                                                   \
+    while (((pCount) < (pSize)) && ((pDest).fullPolicy == RING_BUFFER_BLOCK))                            \
+    {                                                                                                    \
+        RingBuffer_Block ((pDest));                                                                      \
+        RingBuffer_Write ((pDest),                                                                       \
+                          &((const uint8_t*) (pPtrSource))[(pCount) * RingBuffer_GetTypeSize ((pDest))], \
+                          ((pSize) - (pCount)),                                                          \
+                          0U,                                                                            \
+                          fillMore);                                                                     \
+        (pCount) += fillMore;                                                                            \
+    }                                                                                                    \
+    if ((pCount) < (pSize))                                                                              \
+    {                                                                                                    \
+        RingBuffer_Discard ((pDest), ((pSize) - (pCount)));                                              \
+    }                                                                                                    \
+    else                                                                                                 \
+    {                                                                                                    \
+    }                                                                                                    \
+}
+
+/**
+ * Copies data from linear buffer to circular buffer, advancing the head index and applying the full ring buffer
+ * policy (see \ref RingBuffer_FillCount).
+ *
+ * @param     pDest      Ring buffer to push to.
+ * @param[in] pPtrSource Linear buffer to copy data from.
+ * @param     pSize      Number of slots to fill.
+ */
+#define RingBuffer_Fill(pDest, pPtrSource, pSize)                     \
+{                                                                     \
+    uint32_t fillCount;                                               \
+    RingBuffer_FillCount ((pDest), (pPtrSource), (pSize), fillCount); \
+    (void) fillCount;                                                 \
+}
+
+/**
+ * Splits a run of slots starting at a given position into at most two contiguous spans.
+ *
+ * @param      pName       Ring buffer variable name.
+ * @param      pSlot       Array position of the first slot.
+ * @param      pSize       Number of slots.
+ * @param[out] pPtrFirst   Pointer to the first span (from pSlot up to the end of the array).
+ * @param[out] pFirstSize  Number of slots in the first span.
+ * @param[out] pPtrSecond  Pointer to the second span (from the beginning of the array).
+ * @param[out] pSecondSize Number of slots in the second span (0 if the run does not wrap).
+ */
+#define RingBuffer_GetSpans(pName, pSlot, pSize, pPtrFirst, pFirstSize, pPtrSecond, pSecondSize) \
+{                                                                                                \
+    if ((pSize) > (RingBuffer_GetLength ((pName)) - (pSlot)))                                    \
+    {                                                                                            \
+        (pFirstSize) = (uint32_t) (RingBuffer_GetLength ((pName)) - (pSlot));                    \
+    }                                                                                            \
+    else                                                                                         \
+    {                                                                                            \
+        (pFirstSize) = (pSize);                                                                  \
+    }                                                                                            \
+    (pPtrFirst)   = &(pName).array[(pSlot)];                                                     \
+    (pPtrSecond)  = &(pName).array[0];                                                           \
+    (pSecondSize) = (pSize) - (pFirstSize);                                                      \
+}
+
+/**
+ * Reserves up to pSize free slots to be written in place.
+ *
+ * @note Slots are not visible to the consumer until \ref RingBuffer_Commit is called; only one reservation at a
+ *       time is allowed. Full ring buffer is never overwritten, fewer slots are returned instead.
+ *
+ * @param      pName       Ring buffer to write to.
+ * @param      pSize       Number of slots to reserve.
+ * @param[out] pPtrFirst   Pointer to the first span of reserved slots.
+ * @param[out] pFirstSize  Number of slots in the first span.
+ * @param[out] pPtrSecond  Pointer to the second span of reserved slots.
+ * @param[out] pSecondSize Number of slots in the second span.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Reserve(pName, pSize, pPtrFirst, pFirstSize, pPtrSecond, pSecondSize) \
+    {                                                                                        \
+        uint32_t head;                                                                       \
+        uint32_t used;                                                                       \
+        uint32_t size;                                                                       \
+        head = atomic_load_explicit (&(pName).head, memory_order_relaxed);                   \
+        RingBuffer_GetProducerUsed ((pName), head, (pSize), used);                           \
+        if ((pSize) > (RingBuffer_GetCapacity ((pName)) - used))                             \
+        {                                                                                    \
+            size = (uint32_t) (RingBuffer_GetCapacity ((pName)) - used);                     \
+        }                                                                                    \
+        else                                                                                 \
+        {                                                                                    \
+            size = (pSize);                                                                  \
+        }                                                                                    \
+        RingBuffer_GetSpans ((pName), RingBuffer_GetSlot ((pName), head), size,              \
+                             (pPtrFirst), (pFirstSize), (pPtrSecond), (pSecondSize));        \
+    }
+#else
+    #define RingBuffer_Reserve(pName, pSize, pPtrFirst, pFirstSize, pPtrSecond, pSecondSize)          \
+    {                                                                                                 \
+        uint32_t available;                                                                           \
+        uint32_t size;                                                                                \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        available = (uint32_t) RingBuffer_GetFree ((pName));                                          \
+        if ((pSize) > available)                                                                      \
+        {                                                                                             \
+            size = available;                                                                         \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            size = (pSize);                                                                           \
+        }                                                                                             \
+        RingBuffer_GetSpans ((pName), RingBuffer_GetSlot ((pName), (pName).head), size,               \
+                             (pPtrFirst), (pFirstSize), (pPtrSecond), (pSecondSize));                 \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Commits slots previously written in place, making them visible to the consumer.
+ *
+ * @param pName Ring buffer to commit to.
+ * @param pSize Number of slots to commit (at most the reserved ones).
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Commit(pName, pSize)                                         \
+    {                                                                               \
+        uint32_t head;                                                              \
+        head = atomic_load_explicit (&(pName).head, memory_order_relaxed);          \
+        RingBuffer_IncrementLinear (head, (pSize), RingBuffer_GetLength ((pName))); \
+        atomic_store_explicit (&(pName).head, head, memory_order_release);          \
+        RingBuffer_StatsPush ((pName), (pSize));                                    \
+        RingBuffer_WakeConsumers ((pName));                                         \
+    }
+#else
+    #define RingBuffer_Commit(pName, pSize)                                                           \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        RingBuffer_Assert ((pSize) <= RingBuffer_GetFree ((pName)));                                  \
+        RingBuffer_IncrementLinear ((pName).head, (pSize), RingBuffer_GetLength ((pName)));           \
+        RingBuffer_StatsPush ((pName), (pSize));                                                      \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        RingBuffer_WakeConsumers ((pName));                                                           \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Peeks up to pSize used slots to be read in place.
+ *
+ * @note Slots are not freed until \ref RingBuffer_Release is called; only one peek at a time is allowed.
+ * @warning W/ the \ref RING_BUFFER_OVERWRITE full ring buffer policy (unless \ref RING_BUFFER_SPSC is enabled), a
+ *          push on a full ring buffer between peek and release overwrites the peeked slots and moves the tail: the
+ *          release then skips unread items. Producers may run concurrently only w/ another policy.
+ *
+ * @param      pName       Ring buffer to read from.
+ * @param      pSize       Number of slots to peek.
+ * @param[out] pPtrFirst   Pointer to the first span of readable slots.
+ * @param[out] pFirstSize  Number of slots in the first span.
+ * @param[out] pPtrSecond  Pointer to the second span of readable slots.
+ * @param[out] pSecondSize Number of slots in the second span.
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Peek(pName, pSize, pPtrFirst, pFirstSize, pPtrSecond, pSecondSize) \
+    {                                                                                     \
+        uint32_t tail;                                                                    \
+        uint32_t used;                                                                    \
+        uint32_t size;                                                                    \
+        tail = atomic_load_explicit (&(pName).tail, memory_order_relaxed);                \
+        RingBuffer_GetConsumerUsed ((pName), tail, (pSize), used);                        \
+        if ((pSize) > used)                                                               \
+        {                                                                                 \
+            size = used;                                                                  \
+        }                                                                                 \
+        else                                                                              \
+        {                                                                                 \
+            size = (pSize);                                                               \
+        }                                                                                 \
+        RingBuffer_GetSpans ((pName), RingBuffer_GetSlot ((pName), tail), size,           \
+                             (pPtrFirst), (pFirstSize), (pPtrSecond), (pSecondSize));     \
+    }
+#else
+    #define RingBuffer_Peek(pName, pSize, pPtrFirst, pFirstSize, pPtrSecond, pSecondSize)             \
+    {                                                                                                 \
+        uint32_t used;                                                                                \
+        uint32_t size;                                                                                \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        used = RingBuffer_GetUsed ((pName));                                                          \
+        if ((pSize) > used)                                                                           \
+        {                                                                                             \
+            size = used;                                                                              \
+        }                                                                                             \
+        else                                                                                          \
+        {                                                                                             \
+            size = (pSize);                                                                           \
+        }                                                                                             \
+        RingBuffer_GetSpans ((pName), RingBuffer_GetSlot ((pName), (pName).tail), size,               \
+                             (pPtrFirst), (pFirstSize), (pPtrSecond), (pSecondSize));                 \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Releases slots previously read in place, making them available to the producer.
+ *
+ * @warning See \ref RingBuffer_Peek about the \ref RING_BUFFER_OVERWRITE policy.
+ *
+ * @param pName Ring buffer to release to.
+ * @param pSize Number of slots to release (at most the peeked ones).
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_Release(pName, pSize)                                        \
+    {                                                                               \
+        uint32_t tail;                                                              \
+        tail = atomic_load_explicit (&(pName).tail, memory_order_relaxed);          \
+        RingBuffer_IncrementLinear (tail, (pSize), RingBuffer_GetLength ((pName))); \
+        atomic_store_explicit (&(pName).tail, tail, memory_order_release);          \
+        RingBuffer_StatsPop ((pName), (pSize));                                     \
+        RingBuffer_WakeProducers ((pName));                                         \
+    }
+#else
+    #define RingBuffer_Release(pName, pSize)                                                          \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsLocked ((pName));                                                             \
+        RingBuffer_Assert ((pSize) <= RingBuffer_GetUsed ((pName)));                                  \
+        RingBuffer_IncrementTail ((pName), (pSize));                                                  \
+        RingBuffer_StatsPop ((pName), (pSize));                                                       \
+        RingBuffer_StatsUnlocking ((pName));                                                          \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+        RingBuffer_WakeProducers ((pName));                                                           \
+    }
+#endif /* RING_BUFFER_SPSC == 1 */
+
+#if (RING_BUFFER_NOTIFY == 1)
+/**
+ * Attaches a readiness notifier to ring buffer and arms it (if \ref RING_BUFFER_NOTIFY is enabled).
+ *
+ * The fd (e.g. from eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC)) becomes readable on the empty -> non-empty transition,
+ * so a single-threaded event loop can poll it w/ epoll or io_uring next to its sockets.
+ *
+ * @note Must be called after \ref RingBuffer_Init (which disarms the notifier) and before pushing.
+ *
+ * @param pName Ring buffer variable name.
+ * @param pFd   Eventfd to signal (any fd accepting an 8-byte write of 1).
+ */
+    #define RingBuffer_NotifyInit(pName, pFd)                                   \
+    {                                                                           \
+        (pName).notifyFd = (pFd);                                               \
+        atomic_store_explicit (&(pName).notifyArmed, 1U, memory_order_seq_cst); \
+    }
+
+/**
+ * Re-arms the readiness notifier once the consumer drained ring buffer (if \ref RING_BUFFER_NOTIFY is enabled).
+ *
+ * The consumer reads the eventfd, pops until empty, then re-arms: if items raced in meanwhile the notifier is left
+ * disarmed and the consumer keeps popping instead of going back to the event loop.
+ *
+ * @param      pName  Ring buffer variable name.
+ * @param[out] pEmpty 1 if re-armed (wait for the next event), 0 if items are pending (keep popping).
+ */
+    #define RingBuffer_NotifyRearm(pName, pEmpty)                                   \
+    {                                                                               \
+        atomic_store_explicit (&(pName).notifyArmed, 1U, memory_order_seq_cst);     \
+        (pEmpty) = (RingBuffer_IsEmpty ((pName)) != 0) ? 1 : 0;                     \
+        if ((pEmpty) == 0)                                                          \
+        {                                                                           \
+            atomic_store_explicit (&(pName).notifyArmed, 0U, memory_order_relaxed); \
+        }                                                                           \
+        else                                                                        \
+        {                                                                           \
+        }                                                                           \
+    }
+#endif /* RING_BUFFER_NOTIFY == 1 */
+
+#if (RING_BUFFER_STATS == 1)
+/**
+ * Takes a snapshot of ring buffer statistics (if \ref RING_BUFFER_STATS is enabled).
+ *
+ * @note The high-water mark is the peak seen by the producer (see \ref RingBuffer_StatsUsed).
+ *
+ * @param      pName  Ring buffer variable name.
+ * @param[out] pStats \ref RingBuffer_Stats_t to copy statistics to.
+ */
+    #define RingBuffer_GetStats(pName, pStats)                                                        \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        (pStats).pushes      = RingBuffer_StatsLoad ((pName).producerStats.pushes);                   \
+        (pStats).pops        = RingBuffer_StatsLoad ((pName).consumerStats.pops);                     \
+        (pStats).overwritten = RingBuffer_StatsLoad ((pName).producerStats.overwritten);              \
+        (pStats).dropped     = RingBuffer_GetDropped ((pName));                                       \
+        (pStats).highWater   = RingBuffer_StatsLoad ((pName).producerStats.highWater);                \
+        (pStats).lockTime    = (pName).producerStats.lockTime;                                        \
+        (pStats).lockTimeMax = (pName).producerStats.lockTimeMax;                                     \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+    }
+
+/**
+ * Resets ring buffer statistics (if \ref RING_BUFFER_STATS is enabled).
+ *
+ * @note The dropped items counter is reset too (see \ref RingBuffer_GetDropped).
+ * @warning If \ref RING_BUFFER_SPSC is enabled, counters updated concurrently may miss the reset.
+ *
+ * @param pName Ring buffer variable name.
+ */
+    #define RingBuffer_ResetStats(pName)                                                              \
+    {                                                                                                 \
+        RingBuffer_Protect (RING_BUFFER_LOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg);   \
+        RingBuffer_StatsStore ((pName).producerStats.pushes, 0U);                                     \
+        RingBuffer_StatsStore ((pName).consumerStats.pops, 0U);                                       \
+        RingBuffer_StatsStore ((pName).producerStats.overwritten, 0U);                                \
+        RingBuffer_StatsStore ((pName).dropped, 0U);                                                  \
+        RingBuffer_StatsStore ((pName).producerStats.highWater, 0U);                                  \
+        (pName).producerStats.lockTime    = 0U;                                                       \
+        (pName).producerStats.lockTimeMax = 0U;                                                       \
+        RingBuffer_Protect (RING_BUFFER_UNLOCK, (pName).protect.ptrCallback, (pName).protect.ptrArg); \
+    }
+#endif /* RING_BUFFER_STATS == 1 */
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+#if (RING_BUFFER_STATS == 1)
+/**
+ * Statistics counter type.
+ */
+#if (RING_BUFFER_SPSC == 1)
+typedef _Atomic uint64_t RingBuffer_StatsCounter_t;
+#else
+typedef uint64_t RingBuffer_StatsCounter_t;
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Ring buffer statistics snapshot.
+ */
+typedef struct
+{
+    uint64_t pushes;      /**< Items pushed. */
+    uint64_t pops;        /**< Items popped. */
+    uint64_t overwritten; /**< Oldest items overwritten by pushing into full ring buffer. */
+    uint64_t dropped;     /**< New items discarded by pushing into full ring buffer (\ref RingBuffer_GetDropped). */
+    uint64_t highWater;   /**< Peak number of used slots. */
+    uint64_t lockTime;    /**< Cumulative time between lock and unlock (\ref RingBuffer_StatsClock units). */
+    uint64_t lockTimeMax; /**< Longest time between lock and unlock (\ref RingBuffer_StatsClock units). */
+} RingBuffer_Stats_t;
+#endif /* RING_BUFFER_STATS == 1 */
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+/**
+ * Gets the number of slots between two indexes.
+ *
+ * @note Used to compute the occupancy from a single snapshot of both indexes.
+ *
+ * @param head   Head index.
+ * @param tail   Tail index.
+ * @param length Ring buffer length.
+ *
+ * @return The number of slots from tail to head.
+ */
+static inline uint32_t
+RingBuffer_Distance (uint32_t head, uint32_t tail, uint32_t length)
+{
+    uint32_t distance;
+
+#if (RING_BUFFER_POW2 == 1)
+    (void) length;
+
+    distance = head - tail;
+#else
+    if (head >= tail)
+    {
+        distance = head - tail;
+    }
+    else
+    {
+        distance = (length - tail) + head;
+    }
+#endif /* RING_BUFFER_POW2 == 1 */
+
+    return distance;
+}
+
+/**
+ * Hints the CPU that the caller is busy-waiting.
+ */
+static inline void
+RingBuffer_CpuRelax (void)
+{
+#if defined (__x86_64__) || defined (__i386__)
+    __builtin_ia32_pause ();
+#elif defined (__aarch64__)
+    __asm__ volatile ("yield");
+#else
+#endif /* defined (__x86_64__) || defined (__i386__) */
+}
+
+#if (RING_BUFFER_WAIT == 1)
+/**
+ * Gets the absolute deadline of a blocking operation.
+ *
+ * @param      timeout     Timeout in milliseconds (\ref RING_BUFFER_WAIT_FOREVER to wait forever).
+ * @param[out] ptrDeadline Absolute CLOCK_MONOTONIC deadline.
+ *
+ * @return ptrDeadline, NULL if waiting forever.
+ */
+static inline const struct timespec*
+RingBuffer_GetDeadline (uint32_t timeout, struct timespec* ptrDeadline)
+{
+    const struct timespec* ptrRes;
+
+    ptrRes = NULL;
+
+    if (timeout != RING_BUFFER_WAIT_FOREVER)
+    {
+        (void) clock_gettime (CLOCK_MONOTONIC, ptrDeadline);
+
+        ptrDeadline->tv_sec  += (time_t) (timeout / 1000U);
+        ptrDeadline->tv_nsec += (long) ((timeout % 1000U) * 1000000U);
+
+        if (ptrDeadline->tv_nsec >= 1000000000L)
+        {
+            ptrDeadline->tv_sec  += 1;
+            ptrDeadline->tv_nsec -= 1000000000L;
+        }
+        else
+        {
+        }
+
+        ptrRes = ptrDeadline;
+    }
+    else
+    {
+    }
+
+    return ptrRes;
+}
+
+/**
+ * Parks the caller until the index changes from its expected value, it is woken up or the deadline expires.
+ *
+ * @param[in] ptrIndex    Head or tail index.
+ * @param     expected    Index value the caller saw.
+ * @param[in] ptrDeadline Absolute CLOCK_MONOTONIC deadline (NULL to wait forever).
+ *
+ * @return 1 if the deadline expired, 0 otherwise.
+ */
+static inline int32_t
+RingBuffer_FutexWait (const volatile void* ptrIndex, uint32_t expected, const struct timespec* ptrDeadline)
+{
+    long res;
+
+    res = syscall (SYS_futex, ptrIndex, (FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG), expected, ptrDeadline, NULL,
+                   FUTEX_BITSET_MATCH_ANY);
+
+    return ((res != 0L) && (errno == ETIMEDOUT)) ? 1 : 0;
+}
+
+/**
+ * Wakes all the callers parked on an index.
+ *
+ * @param[in] ptrIndex Head or tail index.
+ */
+static inline void
+RingBuffer_FutexWake (const volatile void* ptrIndex)
+{
+    (void) syscall (SYS_futex, ptrIndex, (FUTEX_WAKE | FUTEX_PRIVATE_FLAG), INT_MAX, NULL, NULL, 0);
+}
+#endif /* RING_BUFFER_WAIT == 1 */
+
+#if (RING_BUFFER_NOTIFY == 1)
+/**
+ * Signals a readiness notifier (adds 1 to the eventfd counter).
+ *
+ * @param fd Eventfd to signal.
+ */
+static inline void
+RingBuffer_NotifySignal (int fd)
+{
+    uint64_t one;
+
+    one = 1U;
+
+    (void) write (fd, &one, sizeof (one));
+}
+#endif /* RING_BUFFER_NOTIFY == 1 */
+
+#if (RING_BUFFER_COPY_X86 == 1)
+/**
+ * Copies bytes w/ 16-byte non-temporal stores (SSE2).
+ *
+ * @param[out] ptrDest   Destination.
+ * @param[in]  ptrSource Source.
+ * @param      size      Number of bytes to copy (at least 64).
+ */
+__attribute__ ((target ("sse2"))) static inline void
+RingBuffer_CopyStreamSse2 (uint8_t* ptrDest, const uint8_t* ptrSource, size_t size)
+{
+    size_t  head;
+    __m128i a;
+    __m128i b;
+    __m128i c;
+    __m128i d;
+
+    /* Streaming stores need an aligned destination: the unaligned head goes through the cache. */
+    head = (size_t) ((16U - ((uintptr_t) ptrDest & 15U)) & 15U);
+
+    (void) memcpy (ptrDest, ptrSource, head);
+
+    for (size -= head, ptrDest += head, ptrSource += head; size >= 64U; size -= 64U, ptrDest += 64, ptrSource += 64)
+    {
+        a = _mm_loadu_si128 ((const __m128i*) &ptrSource[0]);
+        b = _mm_loadu_si128 ((const __m128i*) &ptrSource[16]);
+        c = _mm_loadu_si128 ((const __m128i*) &ptrSource[32]);
+        d = _mm_loadu_si128 ((const __m128i*) &ptrSource[48]);
+
+        _mm_stream_si128 ((__m128i*) &ptrDest[0], a);
+        _mm_stream_si128 ((__m128i*) &ptrDest[16], b);
+        _mm_stream_si128 ((__m128i*) &ptrDest[32], c);
+        _mm_stream_si128 ((__m128i*) &ptrDest[48], d);
+    }
+
+    (void) memcpy (ptrDest, ptrSource, size);
+
+    /* Streaming stores are weakly ordered: make them visible before the index is published. */
+    _mm_sfence ();
+}
+
+/**
+ * Copies bytes w/ 32-byte non-temporal stores (AVX2).
+ *
+ * @param[out] ptrDest   Destination.
+ * @param[in]  ptrSource Source.
+ * @param      size      Number of bytes to copy (at least 128).
+ */
+__attribute__ ((target ("avx2"))) static inline void
+RingBuffer_CopyStreamAvx2 (uint8_t* ptrDest, const uint8_t* ptrSource, size_t size)
+{
+    size_t  head;
+    __m256i a;
+    __m256i b;
+    __m256i c;
+    __m256i d;
+
+    head = (size_t) ((32U - ((uintptr_t) ptrDest & 31U)) & 31U);
+
+    (void) memcpy (ptrDest, ptrSource, head);
+
+    for (size -= head, ptrDest += head, ptrSource += head; size >= 128U; size -= 128U, ptrDest += 128, ptrSource += 128)
+    {
+        a = _mm256_loadu_si256 ((const __m256i*) &ptrSource[0]);
+        b = _mm256_loadu_si256 ((const __m256i*) &ptrSource[32]);
+        c = _mm256_loadu_si256 ((const __m256i*) &ptrSource[64]);
+        d = _mm256_loadu_si256 ((const __m256i*) &ptrSource[96]);
+
+        _mm256_stream_si256 ((__m256i*) &ptrDest[0], a);
+        _mm256_stream_si256 ((__m256i*) &ptrDest[32], b);
+        _mm256_stream_si256 ((__m256i*) &ptrDest[64], c);
+        _mm256_stream_si256 ((__m256i*) &ptrDest[96], d);
+    }
+
+    (void) memcpy (ptrDest, ptrSource, size);
+
+    _mm_sfence ();
+}
+
+/**
+ * Copies bytes w/ 64-byte non-temporal stores (AVX-512).
+ *
+ * @param[out] ptrDest   Destination.
+ * @param[in]  ptrSource Source.
+ * @param      size      Number of bytes to copy (at least 256).
+ */
+__attribute__ ((target ("avx512f"))) static inline void
+RingBuffer_CopyStreamAvx512 (uint8_t* ptrDest, const uint8_t* ptrSource, size_t size)
+{
+    size_t  head;
+    __m512i a;
+    __m512i b;
+    __m512i c;
+    __m512i d;
+
+    head = (size_t) ((64U - ((uintptr_t) ptrDest & 63U)) & 63U);
+
+    (void) memcpy (ptrDest, ptrSource, head);
+
+    for (size -= head, ptrDest += head, ptrSource += head; size >= 256U; size -= 256U, ptrDest += 256, ptrSource += 256)
+    {
+        a = _mm512_loadu_si512 ((const void*) &ptrSource[0]);
+        b = _mm512_loadu_si512 ((const void*) &ptrSource[64]);
+        c = _mm512_loadu_si512 ((const void*) &ptrSource[128]);
+        d = _mm512_loadu_si512 ((const void*) &ptrSource[192]);
+
+        _mm512_stream_si512 ((__m512i*) &ptrDest[0], a);
+        _mm512_stream_si512 ((__m512i*) &ptrDest[64], b);
+        _mm512_stream_si512 ((__m512i*) &ptrDest[128], c);
+        _mm512_stream_si512 ((__m512i*) &ptrDest[192], d);
+    }
+
+    (void) memcpy (ptrDest, ptrSource, size);
+
+    _mm_sfence ();
+}
+#endif /* RING_BUFFER_COPY_X86 == 1 */
+
+#if (RING_BUFFER_COPY_STREAM == 1)
+/**
+ * Copies bytes bypassing the cache from \ref RING_BUFFER_COPY_THRESHOLD bytes on, so that large transfers the other
+ * side will not read soon do not evict the working set.
+ *
+ * @note The widest streaming kernel the CPU supports is selected at runtime (AVX-512, AVX2, SSE2); smaller copies and
+ *       other architectures use memcpy.
+ *
+ * @param[out] ptrDest   Destination.
+ * @param[in]  ptrSource Source.
+ * @param      size      Number of bytes to copy.
+ */
+static inline void
+RingBuffer_CopyStream (void* ptrDest, const void* ptrSource, size_t size)
+{
+#if (RING_BUFFER_COPY_X86 == 1)
+    if (size < (size_t) RING_BUFFER_COPY_THRESHOLD)
+    {
+        (void) memcpy (ptrDest, ptrSource, size);
+    }
+    else if (__builtin_cpu_supports ("avx512f"))
+    {
+        RingBuffer_CopyStreamAvx512 ((uint8_t*) ptrDest, (const uint8_t*) ptrSource, size);
+    }
+    else if (__builtin_cpu_supports ("avx2"))
+    {
+        RingBuffer_CopyStreamAvx2 ((uint8_t*) ptrDest, (const uint8_t*) ptrSource, size);
+    }
+    else if (__builtin_cpu_supports ("sse2"))
+    {
+        RingBuffer_CopyStreamSse2 ((uint8_t*) ptrDest, (const uint8_t*) ptrSource, size);
+    }
+    else
+    {
+        (void) memcpy (ptrDest, ptrSource, size);
+    }
+#else
+    (void) memcpy (ptrDest, ptrSource, size);
+#endif /* RING_BUFFER_COPY_X86 == 1 */
+}
+#endif /* RING_BUFFER_COPY_STREAM == 1 */
+
+#if (RING_BUFFER_STATS == 1)
+/**
+ * Default time source for lock hold time statistics.
+ *
+ * @return CLOCK_MONOTONIC time in ns.
+ */
+static inline uint64_t
+RingBuffer_StatsMonotonic (void)
+{
+    struct timespec now;
+
+    (void) clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t) now.tv_sec * 1000000000U) + (uint64_t) now.tv_nsec;
+}
+#endif /* RING_BUFFER_STATS == 1 */
 
 #endif /* RING_BUFFER_H__ */
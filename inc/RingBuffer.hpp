@@ -0,0 +1,800 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer.hpp
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only ring buffer C++ template (C++17).
+ *
+ * Elements are constructed in place on push / emplace and destroyed in place on pop, so non-trivially-copyable and
+ * move-only types are supported. Capacity is a template parameter: power-of-two capacities use free-running masked
+ * indexes and no spare slot, the others keep one slot free to tell full from empty. Thread-safety is selected by the
+ * policy: \ref RingBuffer_Unprotected, \ref RingBuffer_Spsc (lock-free, C++ atomics) or \ref RingBuffer_Protected.
+ *
+ * If built as C++20, async_pop / async_push return awaitables suspending the coroutine on an empty / full ring buffer,
+ * resumed by the push / pop that unblocks it (no threads involved, e.g. single-threaded epoll / io_uring loops).
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_HPP__
+#define RING_BUFFER_HPP__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+/* Configuration. */
+#include "RingBuffer_Conf.h"
+
+#if defined (__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+    /* Standard includes. */
+    #include <coroutine>
+    #include <optional>
+    /* Awaitable async_pop / async_push are available. */
+    #define RING_BUFFER_COROUTINES 1
+#else
+    #define RING_BUFFER_COROUTINES 0
+#endif /* defined (__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L) */
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+#ifndef RING_BUFFER_CACHE_LINE_SIZE
+    #define RING_BUFFER_CACHE_LINE_SIZE 64
+#endif /* RING_BUFFER_CACHE_LINE_SIZE */
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/**
+ * Single-thread policy: no protection at all.
+ */
+struct RingBuffer_Unprotected
+{
+    static constexpr bool spsc = false;
+
+    void lock () {}
+    void unlock () {}
+};
+
+/**
+ * Lock-free single-producer/single-consumer policy: head and tail are atomics w/ acquire/release ordering.
+ *
+ * @note As for \ref RING_BUFFER_SPSC, full ring buffer is never overwritten.
+ */
+struct RingBuffer_Spsc
+{
+    static constexpr bool spsc = true;
+
+    void lock () {}
+    void unlock () {}
+};
+
+/**
+ * Thread-safe policy: every operation holds a lockable (e.g. std::mutex), as the C protect callback.
+ *
+ * @tparam Lockable Type providing lock() / unlock().
+ */
+template <typename Lockable>
+struct RingBuffer_Protected
+{
+    static constexpr bool spsc = false;
+
+    void lock () { lockable.lock (); }
+    void unlock () { lockable.unlock (); }
+
+    Lockable lockable;
+};
+
+/**
+ * Ring buffer.
+ *
+ * @tparam T      Type of ring buffer elements.
+ * @tparam N      Number of usable slots.
+ * @tparam Policy Thread-safety policy.
+ */
+template <typename T, std::uint32_t N, typename Policy = RingBuffer_Unprotected>
+class RingBuffer : private Policy
+{
+  public:
+    static_assert (N > 0U, "Ring buffer capacity must not be zero");
+    static_assert (N < (UINT32_MAX / 2U), "Ring buffer capacity too large for 32-bit indexes");
+
+    /** True if capacity is a power of two (masked free-running indexes). */
+    static constexpr bool pow2 = ((N & (N - 1U)) == 0U);
+
+    /** Number of slots (one is kept free if capacity is not a power of two). */
+    static constexpr std::uint32_t length = pow2 ? N : (N + 1U);
+
+    RingBuffer () = default;
+
+    RingBuffer (const RingBuffer&)            = delete;
+    RingBuffer& operator= (const RingBuffer&) = delete;
+
+    ~RingBuffer () { clear (); }
+
+    /**
+     * Gets the number of usable slots.
+     */
+    static constexpr std::uint32_t
+    capacity () { return N; }
+
+    /**
+     * Gets the number of used slots.
+     */
+    std::uint32_t
+    size () const { return distance (load (head, std::memory_order_acquire), load (tail, std::memory_order_acquire)); }
+
+    /**
+     * Checks if the ring buffer is empty.
+     */
+    bool
+    empty () const { return size () == 0U; }
+
+    /**
+     * Checks if the ring buffer is full.
+     */
+    bool
+    full () const { return size () == N; }
+
+    /**
+     * Constructs an item in place at head, unless the ring buffer is full.
+     *
+     * @param args Item constructor arguments.
+     *
+     * @return True if pushed, false if ring buffer is full.
+     */
+    template <typename... Args>
+    bool
+    try_emplace (Args&&... args)
+    {
+        Resumer       ready;
+        Guard         guard (*this);
+        std::uint32_t headIndex;
+        bool          res;
+
+        headIndex = load (head, std::memory_order_relaxed);
+        res       = (producerUsed (headIndex) < N);
+
+        if (res)
+        {
+            ::new (slot (headIndex)) T (std::forward<Args> (args)...);
+
+            store (head, advance (headIndex, 1U), std::memory_order_release);
+
+            ready.waiters = handOff ();
+        }
+
+        return res;
+    }
+
+    /**
+     * Constructs an item in place at head.
+     *
+     * @note As \ref RingBuffer_Push, the oldest item is destroyed if ring buffer is full, unless the policy is
+     *       \ref RingBuffer_Spsc: then the new item is discarded.
+     *
+     * @param args Item constructor arguments.
+     */
+    template <typename... Args>
+    void
+    emplace (Args&&... args)
+    {
+        if constexpr (Policy::spsc)
+        {
+            (void) try_emplace (std::forward<Args> (args)...);
+        }
+        else
+        {
+            Resumer ready;
+            Guard   guard (*this);
+
+            if (distance (head, tail) == N)
+            {
+                destroy (tail);
+
+                tail = advance (tail, 1U);
+            }
+
+            ::new (slot (head)) T (std::forward<Args> (args)...);
+
+            head = advance (head, 1U);
+
+            ready.waiters = handOff ();
+        }
+    }
+
+    /**
+     * Pushes a copy / moved item, unless the ring buffer is full.
+     *
+     * @return True if pushed, false if ring buffer is full.
+     */
+    bool
+    try_push (const T& item) { return try_emplace (item); }
+
+    bool
+    try_push (T&& item) { return try_emplace (std::move (item)); }
+
+    /**
+     * Pushes a copy / moved item (see \ref emplace for the full ring buffer behaviour).
+     */
+    void
+    push (const T& item) { emplace (item); }
+
+    void
+    push (T&& item) { emplace (std::move (item)); }
+
+    /**
+     * Moves the item at tail out and destroys it in place, unless the ring buffer is empty.
+     *
+     * @param[out] item Item to move the popped item to.
+     *
+     * @return True if popped, false if ring buffer is empty.
+     */
+    bool
+    try_pop (T& item)
+    {
+        Resumer       ready;
+        Guard         guard (*this);
+        std::uint32_t tailIndex;
+        bool          res;
+
+        tailIndex = load (tail, std::memory_order_relaxed);
+        res       = (consumerUsed (tailIndex) != 0U);
+
+        if (res)
+        {
+            item = std::move (*slot (tailIndex));
+
+            destroy (tailIndex);
+
+            store (tail, advance (tailIndex, 1U), std::memory_order_release);
+
+            ready.waiters = handOff ();
+        }
+
+        return res;
+    }
+
+    /**
+     * Moves the item at tail out and destroys it in place.
+     *
+     * @warning Ring buffer must not be empty (asserted, as \ref RingBuffer_Pop).
+     *
+     * @return The popped item.
+     */
+    T
+    pop ()
+    {
+        Resumer       ready;
+        Guard         guard (*this);
+        std::uint32_t tailIndex;
+
+        tailIndex = load (tail, std::memory_order_relaxed);
+
+        RingBuffer_Assert (consumerUsed (tailIndex) != 0U);
+
+        T item (std::move (*slot (tailIndex)));
+
+        destroy (tailIndex);
+
+        store (tail, advance (tailIndex, 1U), std::memory_order_release);
+
+        ready.waiters = handOff ();
+
+        return item;
+    }
+
+    /**
+     * Destroys all the items.
+     *
+     * @warning If the policy is \ref RingBuffer_Spsc, neither the producer nor the consumer must be running.
+     */
+    void
+    clear ()
+    {
+        Resumer       ready;
+        Guard         guard (*this);
+        std::uint32_t tailIndex;
+        std::uint32_t headIndex;
+
+        tailIndex = load (tail, std::memory_order_relaxed);
+        headIndex = load (head, std::memory_order_relaxed);
+
+        while (tailIndex != headIndex)
+        {
+            destroy (tailIndex);
+
+            tailIndex = advance (tailIndex, 1U);
+        }
+
+        store (tail, tailIndex, std::memory_order_relaxed);
+
+        ready.waiters = handOff ();
+    }
+
+  private:
+    /**
+     * Coroutine parked on an empty / full ring buffer (intrusive FIFO node living in the coroutine frame).
+     */
+    class Waiter
+    {
+      public:
+        Waiter* next {nullptr};
+#if (RING_BUFFER_COROUTINES == 1)
+        std::coroutine_handle<> handle;
+#endif /* RING_BUFFER_COROUTINES == 1 */
+    };
+
+    /**
+     * Scoped resumption of the waiters handed an item / a slot. Declared before the \ref Guard, so they are resumed
+     * once the policy lock is released.
+     */
+    class Resumer
+    {
+      public:
+        ~Resumer ()
+        {
+#if (RING_BUFFER_COROUTINES == 1)
+            Waiter* next;
+
+            while (waiters != nullptr)
+            {
+                /* Resumed coroutine may complete and free its frame, hence the node. */
+                next = waiters->next;
+
+                waiters->handle.resume ();
+
+                waiters = next;
+            }
+#endif /* RING_BUFFER_COROUTINES == 1 */
+        }
+
+        Waiter* waiters {nullptr};
+    };
+
+  public:
+#if (RING_BUFFER_COROUTINES == 1)
+    class PopAwaiter;
+    class PushAwaiter;
+
+    /**
+     * Pops an item, suspending the calling coroutine while the ring buffer is empty: co_await yields the item.
+     *
+     * @note Parked coroutines are served in FIFO order and resumed by the push handing them an item, on the pushing
+     *       thread, once the policy lock is released. Not available w/ \ref RingBuffer_Spsc.
+     * @warning The ring buffer must outlive the coroutines parked on it.
+     *
+     * @return Awaitable yielding the popped item.
+     */
+    PopAwaiter
+    async_pop ()
+    {
+        static_assert (!Policy::spsc, "Awaitables need a policy w/ a lock (parked coroutines are shared state)");
+
+        return PopAwaiter (*this);
+    }
+
+    /**
+     * Pushes a copy / moved item, suspending the calling coroutine while the ring buffer is full (never overwrites).
+     *
+     * @note Parked coroutines are served in FIFO order and resumed by the pop making room for their item, on the
+     *       popping thread, once the policy lock is released. Not available w/ \ref RingBuffer_Spsc.
+     * @warning The ring buffer must outlive the coroutines parked on it.
+     *
+     * @return Awaitable completing once the item is pushed.
+     */
+    PushAwaiter
+    async_push (const T& item)
+    {
+        static_assert (!Policy::spsc, "Awaitables need a policy w/ a lock (parked coroutines are shared state)");
+
+        return PushAwaiter (*this, item);
+    }
+
+    PushAwaiter
+    async_push (T&& item)
+    {
+        static_assert (!Policy::spsc, "Awaitables need a policy w/ a lock (parked coroutines are shared state)");
+
+        return PushAwaiter (*this, std::move (item));
+    }
+
+    /**
+     * Awaitable returned by \ref async_pop.
+     */
+    class PopAwaiter : private Waiter
+    {
+      public:
+        explicit PopAwaiter (RingBuffer& ring) : ring (ring) {}
+
+        PopAwaiter (const PopAwaiter&)            = delete;
+        PopAwaiter& operator= (const PopAwaiter&) = delete;
+
+        bool
+        await_ready () { return ring.popOrPark (*this, false); }
+
+        /* Checked again under the lock: a push may have slipped in since await_ready. */
+        bool
+        await_suspend (std::coroutine_handle<> caller)
+        {
+            this->handle = caller;
+
+            return !ring.popOrPark (*this, true);
+        }
+
+        T
+        await_resume () { return std::move (*item); }
+
+      private:
+        friend class RingBuffer;
+
+        RingBuffer&      ring;
+        std::optional<T> item;
+    };
+
+    /**
+     * Awaitable returned by \ref async_push.
+     */
+    class PushAwaiter : private Waiter
+    {
+      public:
+        template <typename U>
+        PushAwaiter (RingBuffer& ring, U&& value) : ring (ring), item (std::forward<U> (value)) {}
+
+        PushAwaiter (const PushAwaiter&)            = delete;
+        PushAwaiter& operator= (const PushAwaiter&) = delete;
+
+        bool
+        await_ready () { return ring.pushOrPark (*this, false); }
+
+        /* Checked again under the lock: a pop may have slipped in since await_ready. */
+        bool
+        await_suspend (std::coroutine_handle<> caller)
+        {
+            this->handle = caller;
+
+            return !ring.pushOrPark (*this, true);
+        }
+
+        void
+        await_resume () {}
+
+      private:
+        friend class RingBuffer;
+
+        RingBuffer& ring;
+        T           item;
+    };
+#endif /* RING_BUFFER_COROUTINES == 1 */
+
+  private:
+    using Index = std::conditional_t<Policy::spsc, std::atomic<std::uint32_t>, std::uint32_t>;
+
+    /**
+     * Scoped policy lock.
+     */
+    class Guard
+    {
+      public:
+        explicit Guard (RingBuffer& ring) : policy (ring) { policy.lock (); }
+        ~Guard () { policy.unlock (); }
+
+      private:
+        Policy& policy;
+    };
+
+    /**
+     * Hands the items / slots freed by the last operation to the parked coroutines (w/ the policy lock held).
+     *
+     * @return Chain of the waiters to resume (see \ref Resumer).
+     */
+    Waiter*
+    handOff ()
+    {
+        Waiter* ready;
+
+        ready = nullptr;
+
+#if (RING_BUFFER_COROUTINES == 1)
+        if constexpr (!Policy::spsc)
+        {
+            WaitQueue served;
+            bool      progress;
+
+            do
+            {
+                progress = false;
+
+                if ((popWaiters.first != nullptr) && (distance (head, tail) != 0U))
+                {
+                    PopAwaiter& awaiter = static_cast<PopAwaiter&> (*popWaiters.dequeue ());
+
+                    awaiter.item.emplace (std::move (*slot (tail)));
+
+                    destroy (tail);
+
+                    tail     = advance (tail, 1U);
+                    progress = true;
+
+                    served.enqueue (awaiter);
+                }
+
+                if ((pushWaiters.first != nullptr) && (distance (head, tail) < N))
+                {
+                    PushAwaiter& awaiter = static_cast<PushAwaiter&> (*pushWaiters.dequeue ());
+
+                    ::new (slot (head)) T (std::move (awaiter.item));
+
+                    head     = advance (head, 1U);
+                    progress = true;
+
+                    served.enqueue (awaiter);
+                }
+            } while (progress);
+
+            ready = served.first;
+        }
+#endif /* RING_BUFFER_COROUTINES == 1 */
+
+        return ready;
+    }
+
+#if (RING_BUFFER_COROUTINES == 1)
+    /**
+     * Intrusive FIFO of parked coroutines.
+     */
+    class WaitQueue
+    {
+      public:
+        void
+        enqueue (Waiter& waiter)
+        {
+            waiter.next = nullptr;
+
+            if (last != nullptr)
+            {
+                last->next = &waiter;
+            }
+            else
+            {
+                first = &waiter;
+            }
+
+            last = &waiter;
+        }
+
+        Waiter*
+        dequeue ()
+        {
+            Waiter* waiter;
+
+            waiter = first;
+            first  = waiter->next;
+
+            if (first == nullptr)
+            {
+                last = nullptr;
+            }
+
+            return waiter;
+        }
+
+        Waiter* first {nullptr};
+        Waiter* last {nullptr};
+    };
+
+    /**
+     * Pops an item into the awaiter, otherwise parks it (if requested).
+     *
+     * @return True if popped, false if ring buffer is empty.
+     */
+    bool
+    popOrPark (PopAwaiter& awaiter, bool park)
+    {
+        Resumer ready;
+        Guard   guard (*this);
+        bool    res;
+
+        res = (distance (head, tail) != 0U);
+
+        if (res)
+        {
+            awaiter.item.emplace (std::move (*slot (tail)));
+
+            destroy (tail);
+
+            tail = advance (tail, 1U);
+
+            ready.waiters = handOff ();
+        }
+        else if (park)
+        {
+            popWaiters.enqueue (awaiter);
+        }
+
+        return res;
+    }
+
+    /**
+     * Pushes the awaiter item, otherwise parks it (if requested).
+     *
+     * @return True if pushed, false if ring buffer is full.
+     */
+    bool
+    pushOrPark (PushAwaiter& awaiter, bool park)
+    {
+        Resumer ready;
+        Guard   guard (*this);
+        bool    res;
+
+        res = (distance (head, tail) < N);
+
+        if (res)
+        {
+            ::new (slot (head)) T (std::move (awaiter.item));
+
+            head = advance (head, 1U);
+
+            ready.waiters = handOff ();
+        }
+        else if (park)
+        {
+            pushWaiters.enqueue (awaiter);
+        }
+
+        return res;
+    }
+#endif /* RING_BUFFER_COROUTINES == 1 */
+
+    static std::uint32_t
+    load (const Index& index, std::memory_order order)
+    {
+        if constexpr (Policy::spsc)
+        {
+            return index.load (order);
+        }
+        else
+        {
+            (void) order;
+
+            return index;
+        }
+    }
+
+    static void
+    store (Index& index, std::uint32_t value, std::memory_order order)
+    {
+        if constexpr (Policy::spsc)
+        {
+            index.store (value, order);
+        }
+        else
+        {
+            (void) order;
+
+            index = value;
+        }
+    }
+
+    static constexpr std::uint32_t
+    distance (std::uint32_t headIndex, std::uint32_t tailIndex)
+    {
+        if constexpr (pow2)
+        {
+            return headIndex - tailIndex;
+        }
+        else
+        {
+            return (headIndex >= tailIndex) ? (headIndex - tailIndex) : ((length - tailIndex) + headIndex);
+        }
+    }
+
+    static constexpr std::uint32_t
+    advance (std::uint32_t index, std::uint32_t size)
+    {
+        if constexpr (pow2)
+        {
+            return index + size;
+        }
+        else
+        {
+            return ((index + size) >= length) ? ((index + size) - length) : (index + size);
+        }
+    }
+
+    T*
+    slot (std::uint32_t index)
+    {
+        if constexpr (pow2)
+        {
+            index &= (length - 1U);
+        }
+
+        return std::launder (reinterpret_cast<T*> (&storage[static_cast<std::size_t> (index) * sizeof (T)]));
+    }
+
+    void
+    destroy (std::uint32_t index)
+    {
+        slot (index)->~T ();
+    }
+
+    /**
+     * Gets the used slots seen by the producer, re-reading the shared tail only if the cached one says full.
+     */
+    std::uint32_t
+    producerUsed (std::uint32_t headIndex)
+    {
+        std::uint32_t used;
+
+        if constexpr (Policy::spsc)
+        {
+            used = distance (headIndex, tailCache);
+
+            if (used >= N)
+            {
+                tailCache = tail.load (std::memory_order_acquire);
+                used      = distance (headIndex, tailCache);
+            }
+        }
+        else
+        {
+            used = distance (headIndex, tail);
+        }
+
+        return used;
+    }
+
+    /**
+     * Gets the used slots seen by the consumer, re-reading the shared head only if the cached one says empty.
+     */
+    std::uint32_t
+    consumerUsed (std::uint32_t tailIndex)
+    {
+        std::uint32_t used;
+
+        if constexpr (Policy::spsc)
+        {
+            used = distance (headCache, tailIndex);
+
+            if (used == 0U)
+            {
+                headCache = head.load (std::memory_order_acquire);
+                used      = distance (headCache, tailIndex);
+            }
+        }
+        else
+        {
+            used = distance (head, tailIndex);
+        }
+
+        return used;
+    }
+
+    alignas (T) unsigned char storage[static_cast<std::size_t> (length) * sizeof (T)];
+
+    alignas (RING_BUFFER_CACHE_LINE_SIZE) Index head {0U};
+    std::uint32_t tailCache {0U}; /**< Producer copy of tail (SPSC only). */
+
+    alignas (RING_BUFFER_CACHE_LINE_SIZE) Index tail {0U};
+    std::uint32_t headCache {0U}; /**< Consumer copy of head (SPSC only). */
+
+#if (RING_BUFFER_COROUTINES == 1)
+    WaitQueue popWaiters;  /**< Coroutines parked on an empty ring buffer. */
+    WaitQueue pushWaiters; /**< Coroutines parked on a full ring buffer. */
+#endif /* RING_BUFFER_COROUTINES == 1 */
+};
+
+#endif /* RING_BUFFER_HPP__ */
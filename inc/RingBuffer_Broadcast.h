@@ -0,0 +1,315 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Broadcast.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only lock-free single-producer/multi-reader broadcast ring buffer util.
+ *
+ * Each item is written once and read by every attached reader, each one through its own cursor and at its own pace.
+ * Each slot carries a sequence counter (position + 1 once written), so a reader can tell a slot not written yet from
+ * one already overwritten, and re-checks it after copying the item. If the producer lapped the reader meanwhile, the
+ * reader skips to the oldest item still available and counts the items it missed.
+ * The full ring buffer policy selects who gives way:
+ * - \ref RING_BUFFER_REJECT: the producer is gated by the slowest attached reader (try push fails while it lags a
+ *   whole ring buffer behind);
+ * - \ref RING_BUFFER_OVERWRITE: the producer never waits, laggards are overrun (see \ref RingBuffer_BroadcastGetLag).
+ *
+ * @note In overwrite mode an overrun reader may copy an item while it is being written: the copy is discarded, but
+ *       the item type must tolerate a torn read (plain data, no pointers dereferenced before the re-check).
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_BROADCAST_H__
+#define RING_BUFFER_BROADCAST_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stdatomic.h>
+#include <stdint.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/**
+ * Macro for creating a broadcast ring buffer.
+ *
+ * @note \ref RingBuffer_BroadcastInit must be called before using the ring buffer.
+ *
+ * @param pStorageClass Storage class for the ring buffer (e.g. static).
+ * @param pType         Type of ring buffer elements (e.g. uint8_t).
+ * @param pName         Ring buffer name.
+ * @param pLength       Ring buffer length (must be a power of two, checked at compile time).
+ * @param pReaders      Maximum number of readers attached at the same time.
+ *
+ * @note If \ref RING_BUFFER_CACHE_ALIGN is enabled, head and each reader cursor lie on separate cache lines.
+ */
+// cppcheck-suppress misra-c2012-20.7; no way to enclose pStorageClass / pName due to X-macro
+#define RingBuffer_BroadcastCreate(pStorageClass, pType, pName, pLength, pReaders) \
+    pStorageClass struct                                                           \
+    {                                                                              \
+        struct                                                                     \
+        {                                                                          \
+            _Atomic uint32_t sequence;                                             \
+            pType            item;                                                 \
+        } slots[(pLength)];                                                        \
+        _Static_assert (((pLength) > 0) && (((pLength) & ((pLength) - 1)) == 0),   \
+                        "Broadcast ring buffer requires a power of two length");   \
+        RingBuffer_CacheAligned _Atomic uint32_t head;                             \
+        uint32_t gateCache;                                                        \
+        uint8_t  policy;                                                           \
+        struct                                                                     \
+        {                                                                          \
+            RingBuffer_CacheAligned _Atomic uint32_t cursor;                       \
+            _Atomic uint32_t lag;                                                  \
+            _Atomic uint32_t active;                                               \
+        } readers[(pReaders)];                                                     \
+    } pName
+
+/**
+ * Gets the total slots number of the broadcast ring buffer.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The slots number of the ring buffer.
+ */
+#define RingBuffer_BroadcastGetLength(pName) \
+    (sizeof ((pName).slots) / sizeof ((pName).slots[0]))
+
+/**
+ * Gets the maximum number of readers of the broadcast ring buffer.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The readers number of the ring buffer.
+ */
+#define RingBuffer_BroadcastGetReaders(pName) \
+    (sizeof ((pName).readers) / sizeof ((pName).readers[0]))
+
+/**
+ * Gets the number of items a reader missed because it was overrun.
+ *
+ * @param pName   Ring buffer variable name.
+ * @param pReader Reader index.
+ *
+ * @return The number of missed items (wraps around).
+ */
+#define RingBuffer_BroadcastGetLag(pName, pReader) \
+    atomic_load_explicit (&(pName).readers[(pReader)].lag, memory_order_relaxed)
+
+/**
+ * Initializes the slot sequences, the indexes and the policy of a broadcast ring buffer.
+ *
+ * @warning Neither the producer nor the readers must be running.
+ *
+ * @param pName   Ring buffer variable name.
+ * @param pPolicy \ref RING_BUFFER_REJECT (producer gated by the slowest reader) or \ref RING_BUFFER_OVERWRITE
+ *                (laggards overrun).
+ */
+#define RingBuffer_BroadcastInit(pName, pPolicy)                                                                   \
+{                                                                                                                  \
+    uint32_t i;                                                                                                    \
+    RingBuffer_Assert (((pPolicy) == RING_BUFFER_REJECT) || ((pPolicy) == RING_BUFFER_OVERWRITE));                 \
+    for (i = 0U; i < RingBuffer_BroadcastGetLength ((pName)); i++)                                                 \
+    {                                                                                                              \
+        atomic_store_explicit (&(pName).slots[i].sequence, i, memory_order_relaxed);                               \
+    }                                                                                                              \
+    for (i = 0U; i < RingBuffer_BroadcastGetReaders ((pName)); i++)                                                \
+    {                                                                                                              \
+        atomic_store_explicit (&(pName).readers[i].cursor, 0U, memory_order_relaxed);                              \
+        atomic_store_explicit (&(pName).readers[i].lag, 0U, memory_order_relaxed);                                 \
+        atomic_store_explicit (&(pName).readers[i].active, 0U, memory_order_relaxed);                              \
+    }                                                                                                              \
+    (pName).gateCache = 0U;                                                                                        \
+    (pName).policy    = (uint8_t) (pPolicy);                                                                       \
+    atomic_store_explicit (&(pName).head, 0U, memory_order_release);                                               \
+}
+
+/**
+ * Attaches a reader to a broadcast ring buffer: it gets the items pushed from now on.
+ *
+ * @param      pName   Ring buffer variable name.
+ * @param[out] pReader Reader index (int32_t), -1 if all readers are attached.
+ */
+#define RingBuffer_BroadcastAttach(pName, pReader)                                                \
+{                                                                                                 \
+    uint32_t i;                                                                                   \
+    uint32_t expected;                                                                            \
+    (pReader) = -1;                                                                               \
+    for (i = 0U; (i < RingBuffer_BroadcastGetReaders ((pName))) && ((pReader) < 0); i++)          \
+    {                                                                                             \
+        expected = 0U;                                                                            \
+        if (atomic_compare_exchange_strong_explicit (&(pName).readers[i].active, &expected, 1U,   \
+                                                     memory_order_acquire, memory_order_relaxed)) \
+        {                                                                                         \
+            atomic_store_explicit (&(pName).readers[i].lag, 0U, memory_order_relaxed);            \
+            atomic_store_explicit (&(pName).readers[i].cursor,                                    \
+                                   atomic_load_explicit (&(pName).head, memory_order_acquire),    \
+                                   memory_order_release);                                         \
+            (pReader) = (int32_t) i;                                                              \
+        }                                                                                         \
+        else                                                                                      \
+        {                                                                                         \
+        }                                                                                         \
+    }                                                                                             \
+}
+
+/**
+ * Detaches a reader from a broadcast ring buffer: it no longer gates the producer.
+ *
+ * @param pName   Ring buffer variable name.
+ * @param pReader Reader index.
+ */
+#define RingBuffer_BroadcastDetach(pName, pReader) \
+    atomic_store_explicit (&(pName).readers[(pReader)].active, 0U, memory_order_release)
+
+/**
+ * Tries to push single item into broadcast ring buffer (single producer).
+ *
+ * @note Attached readers are only scanned when the cached position of the slowest one says the ring buffer is full.
+ *
+ * @param      pName   Ring buffer to push to.
+ * @param      pItem   Item to push.
+ * @param[out] pStatus \ref RING_BUFFER_OK if pushed, \ref RING_BUFFER_FULL if the slowest reader is a whole ring
+ *                     buffer behind (\ref RING_BUFFER_REJECT policy only).
+ */
+#define RingBuffer_BroadcastTryPush(pName, pItem, pStatus)                                           \
+{                                                                                                    \
+    uint32_t position;                                                                               \
+    uint32_t index;                                                                                  \
+    uint32_t i;                                                                                      \
+    uint32_t lagging;                                                                                \
+    uint32_t cursor;                                                                                 \
+    position  = atomic_load_explicit (&(pName).head, memory_order_relaxed);                          \
+    (pStatus) = RING_BUFFER_OK;                                                                      \
+    if (((pName).policy == RING_BUFFER_REJECT) &&                                                    \
+        ((position - (pName).gateCache) >= (uint32_t) RingBuffer_BroadcastGetLength ((pName))))      \
+    {                                                                                                \
+        lagging = 0U;                                                                                \
+        for (i = 0U; i < RingBuffer_BroadcastGetReaders ((pName)); i++)                              \
+        {                                                                                            \
+            cursor = atomic_load_explicit (&(pName).readers[i].cursor, memory_order_acquire);        \
+            if ((atomic_load_explicit (&(pName).readers[i].active, memory_order_acquire) != 0U) &&   \
+                ((position - cursor) > lagging))                                                     \
+            {                                                                                        \
+                lagging = position - cursor;                                                         \
+            }                                                                                        \
+            else                                                                                     \
+            {                                                                                        \
+            }                                                                                        \
+        }                                                                                            \
+        (pName).gateCache = position - lagging;                                                      \
+        if (lagging >= (uint32_t) RingBuffer_BroadcastGetLength ((pName)))                           \
+        {                                                                                            \
+            (pStatus) = RING_BUFFER_FULL;                                                            \
+        }                                                                                            \
+        else                                                                                         \
+        {                                                                                            \
+        }                                                                                            \
+    }                                                                                                \
+    else                                                                                             \
+    {                                                                                                \
+    }                                                                                                \
+    if ((pStatus) == RING_BUFFER_OK)                                                                 \
+    {                                                                                                \
+        index = position & (uint32_t) (RingBuffer_BroadcastGetLength ((pName)) - 1UL);               \
+        atomic_store_explicit (&(pName).slots[index].sequence, position, memory_order_relaxed);      \
+        atomic_thread_fence (memory_order_release);                                                  \
+        (pName).slots[index].item = (pItem);                                                         \
+        atomic_store_explicit (&(pName).slots[index].sequence, position + 1U, memory_order_release); \
+        atomic_store_explicit (&(pName).head, position + 1U, memory_order_release);                  \
+    }                                                                                                \
+    else                                                                                             \
+    {                                                                                                \
+    }                                                                                                \
+}
+
+/**
+ * Tries to pop single item from broadcast ring buffer on behalf of a reader (one thread per reader).
+ *
+ * @param      pName   Ring buffer to pop from.
+ * @param      pReader Reader index, as returned by \ref RingBuffer_BroadcastAttach.
+ * @param      pItem   Item to copy to the popped item.
+ * @param[out] pStatus \ref RING_BUFFER_OK if popped, \ref RING_BUFFER_EMPTY if the reader is up to date.
+ */
+#define RingBuffer_BroadcastTryPop(pName, pReader, pItem, pStatus)                                                    \
+{                                                                                                                     \
+    uint32_t position;                                                                                                \
+    uint32_t index;                                                                                                   \
+    uint32_t sequence;                                                                                                \
+    uint32_t oldest;                                                                                                  \
+    int32_t  diff;                                                                                                    \
+    (pStatus) = RING_BUFFER_BUSY;                                                                                     \
+    position  = atomic_load_explicit (&(pName).readers[(pReader)].cursor, memory_order_relaxed);                      \
+    while ((pStatus) == RING_BUFFER_BUSY)                                                                             \
+    {                                                                                                                 \
+        index    = position & (uint32_t) (RingBuffer_BroadcastGetLength ((pName)) - 1UL);                             \
+        sequence = atomic_load_explicit (&(pName).slots[index].sequence, memory_order_acquire);                       \
+        diff     = (int32_t) (sequence - (position + 1U));                                                            \
+        if (diff == 0)                                                                                                \
+        {                                                                                                             \
+            (pItem) = (pName).slots[index].item;                                                                      \
+            atomic_thread_fence (memory_order_acquire);                                                               \
+            if (atomic_load_explicit (&(pName).slots[index].sequence, memory_order_relaxed) == sequence)              \
+            {                                                                                                         \
+                (pStatus) = RING_BUFFER_OK;                                                                           \
+            }                                                                                                         \
+            else                                                                                                      \
+            {                                                                                                         \
+                diff = 1;                                                                                             \
+            }                                                                                                         \
+        }                                                                                                             \
+        else if (diff < 0)                                                                                            \
+        {                                                                                                             \
+            (pStatus) = RING_BUFFER_EMPTY;                                                                            \
+        }                                                                                                             \
+        else                                                                                                          \
+        {                                                                                                             \
+        }                                                                                                             \
+        if (diff > 0)                                                                                                 \
+        {                                                                                                             \
+            /* Overrun: skip to the oldest item the producer cannot be writing. */                                    \
+            oldest = atomic_load_explicit (&(pName).head, memory_order_acquire) -                                     \
+                     (uint32_t) RingBuffer_BroadcastGetLength ((pName)) + 1U;                                         \
+            if ((int32_t) (oldest - position) > 0)                                                                    \
+            {                                                                                                         \
+                atomic_store_explicit (&(pName).readers[(pReader)].lag,                                               \
+                                       atomic_load_explicit (&(pName).readers[(pReader)].lag, memory_order_relaxed) + \
+                                       (oldest - position),                                                           \
+                                       memory_order_relaxed);                                                         \
+                position = oldest;                                                                                    \
+            }                                                                                                         \
+            else                                                                                                      \
+            {                                                                                                         \
+            }                                                                                                         \
+        }                                                                                                             \
+        else                                                                                                          \
+        {                                                                                                             \
+        }                                                                                                             \
+    }                                                                                                                 \
+    if ((pStatus) == RING_BUFFER_OK)                                                                                  \
+    {                                                                                                                 \
+        atomic_store_explicit (&(pName).readers[(pReader)].cursor, position + 1U, memory_order_release);              \
+    }                                                                                                                 \
+    else                                                                                                              \
+    {                                                                                                                 \
+    }                                                                                                                 \
+}
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+#endif /* RING_BUFFER_BROADCAST_H__ */
@@ -0,0 +1,870 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Desc.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Function-based ring buffer util w/ capacity set at runtime.
+ *
+ * A descriptor holds element size, length, indexes and a pointer to storage supplied by the caller (static array,
+ * arena) or allocated on the heap. Operations are real functions, so call sites do not expand the macro bodies.
+ * \ref RING_BUFFER_PROTECT, \ref RING_BUFFER_SPSC and \ref RING_BUFFER_POW2 are honoured as for the macro flavour.
+ * If \ref RING_BUFFER_DESC_MAP is enabled, large storage can be mapped w/ huge pages, bound to a NUMA node and
+ * prefaulted (Linux only).
+ *
+ * @note If \ref RING_BUFFER_DESC_INLINE is disabled, exactly one translation unit must define
+ *       RING_BUFFER_DESC_IMPLEMENTATION before including this header.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_DESC_H__
+#define RING_BUFFER_DESC_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+#ifndef RING_BUFFER_DESC_MAP
+    #define RING_BUFFER_DESC_MAP 0
+#endif /* RING_BUFFER_DESC_MAP */
+
+#if (RING_BUFFER_DESC_MAP == 1)
+    /* Standard includes. */
+    #include <errno.h>
+    #include <limits.h>
+    /* System includes. */
+    #include <linux/mempolicy.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+#ifndef RING_BUFFER_DESC_INLINE
+    #define RING_BUFFER_DESC_INLINE 1
+#endif /* RING_BUFFER_DESC_INLINE */
+
+#ifndef RING_BUFFER_DESC_HUGE_PAGE_SIZE
+    #define RING_BUFFER_DESC_HUGE_PAGE_SIZE 2097152UL
+#endif /* RING_BUFFER_DESC_HUGE_PAGE_SIZE */
+
+#if (RING_BUFFER_DESC_MAP == 1)
+/**
+ * Map flag: back storage w/ transparent huge pages (madvise, storage aligned to \ref RING_BUFFER_DESC_HUGE_PAGE_SIZE).
+ */
+    #define RING_BUFFER_DESC_MAP_HUGE 0x01U
+
+/**
+ * Map flag: back storage w/ explicit huge pages from the hugetlbfs pool (MAP_HUGETLB, see vm.nr_hugepages).
+ */
+    #define RING_BUFFER_DESC_MAP_HUGETLB 0x02U
+
+/**
+ * Map flag: fault every page in at creation instead of on the first pass through the ring buffer.
+ */
+    #define RING_BUFFER_DESC_MAP_PREFAULT 0x04U
+
+/**
+ * NUMA node meaning no binding: pages come from the node of the thread first touching them.
+ */
+    #define RING_BUFFER_DESC_NODE_ANY -1
+
+/**
+ * Number of NUMA nodes a storage can be bound to.
+ */
+    #define RING_BUFFER_DESC_NODE_MAX 1024
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+
+/**
+ * Linkage of descriptor functions: static inline in every translation unit, or external w/ a single definition.
+ */
+#if (RING_BUFFER_DESC_INLINE == 1)
+    #define RingBuffer_DescApi static inline
+    #define RING_BUFFER_DESC_DEFINE 1
+#elif defined (RING_BUFFER_DESC_IMPLEMENTATION)
+    #define RingBuffer_DescApi
+    #define RING_BUFFER_DESC_DEFINE 1
+#else
+    #define RingBuffer_DescApi
+    #define RING_BUFFER_DESC_DEFINE 0
+#endif /* RING_BUFFER_DESC_INLINE == 1 */
+
+/**
+ * Loads / stores a descriptor index w/ the given ordering (if \ref RING_BUFFER_SPSC is enabled).
+ */
+#if (RING_BUFFER_SPSC == 1)
+    #define RingBuffer_DescLoad(pIndex, pOrder) \
+        atomic_load_explicit (&(pIndex), (pOrder))
+    #define RingBuffer_DescStore(pIndex, pValue, pOrder) \
+        atomic_store_explicit (&(pIndex), (pValue), (pOrder))
+#else
+    #define RingBuffer_DescLoad(pIndex, pOrder) \
+        (pIndex)
+    #define RingBuffer_DescStore(pIndex, pValue, pOrder) \
+        ((pIndex) = (pValue))
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/**
+ * Descriptor index type.
+ */
+#if (RING_BUFFER_SPSC == 1)
+typedef _Atomic uint32_t RingBuffer_DescIndex_t;
+#else
+typedef uint32_t RingBuffer_DescIndex_t;
+#endif /* RING_BUFFER_SPSC == 1 */
+
+/**
+ * Ring buffer descriptor.
+ */
+typedef struct
+{
+    uint8_t*                                       ptrStorage; /**< Slots storage (length * typeSize bytes). */
+    uint32_t                                       typeSize;   /**< Size of each element in bytes. */
+    uint32_t                                       length;     /**< Number of slots. */
+    uint8_t                                        owned;      /**< 1 if storage is on the heap, 2 if mapped. */
+#if (RING_BUFFER_DESC_MAP == 1)
+    size_t                                         mapSize;    /**< Size of mapped storage in bytes. */
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+    RingBuffer_CacheAligned RingBuffer_DescIndex_t head;       /**< Write index. */
+    RingBuffer_CacheAligned RingBuffer_DescIndex_t tail;       /**< Read index. */
+#if (RING_BUFFER_PROTECT == 1)
+    struct
+    {
+        void (*ptrCallback)(uint8_t, void*);
+        void* ptrArg;
+    } protect;
+#endif /* RING_BUFFER_PROTECT == 1 */
+} RingBuffer_Desc_t;
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+/**
+ * Gets the storage size needed by a ring buffer (e.g. to carve it out of an arena).
+ *
+ * @param typeSize Size of each element in bytes.
+ * @param length   Number of slots.
+ *
+ * @return The storage size in bytes.
+ */
+#define RingBuffer_DescGetStorageSize(pTypeSize, pLength) \
+    ((size_t) (pTypeSize) * (size_t) (pLength))
+
+/**
+ * Initializes a ring buffer over caller-provided storage (static array or arena).
+ *
+ * @param[out]     ptrRing     Ring buffer to initialize.
+ * @param[in]      ptrStorage  Storage of at least \ref RingBuffer_DescGetStorageSize bytes.
+ * @param          typeSize    Size of each element in bytes.
+ * @param          length      Number of slots (must be a power of two if \ref RING_BUFFER_POW2 is enabled).
+ * @param[in]      ptrCallback Protect callback (if \ref RING_BUFFER_PROTECT is enabled, ignored otherwise).
+ * @param[in, out] ptrArg      Protect callback pointer to argument (if \ref RING_BUFFER_PROTECT is enabled).
+ */
+RingBuffer_DescApi void
+RingBuffer_DescInit (RingBuffer_Desc_t* ptrRing, void* ptrStorage, uint32_t typeSize, uint32_t length,
+                     void (*ptrCallback)(uint8_t, void*), void* ptrArg);
+
+/**
+ * Initializes a ring buffer w/ storage allocated on the heap.
+ *
+ * @param[out]     ptrRing     Ring buffer to initialize.
+ * @param          typeSize    Size of each element in bytes.
+ * @param          length      Number of slots (must be a power of two if \ref RING_BUFFER_POW2 is enabled).
+ * @param[in]      ptrCallback Protect callback (if \ref RING_BUFFER_PROTECT is enabled, ignored otherwise).
+ * @param[in, out] ptrArg      Protect callback pointer to argument (if \ref RING_BUFFER_PROTECT is enabled).
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise.
+ */
+RingBuffer_DescApi int32_t
+RingBuffer_DescAlloc (RingBuffer_Desc_t* ptrRing, uint32_t typeSize, uint32_t length,
+                      void (*ptrCallback)(uint8_t, void*), void* ptrArg);
+
+#if (RING_BUFFER_DESC_MAP == 1)
+/**
+ * Initializes a ring buffer w/ storage mapped from the kernel, optionally backed by huge pages, bound to a NUMA node
+ * and prefaulted, e.g. for multi-GB capture rings that would otherwise take dTLB misses and cross-node traffic.
+ *
+ * @note If the hugetlbfs pool cannot satisfy \ref RING_BUFFER_DESC_MAP_HUGETLB, transparent huge pages are requested
+ *       instead.
+ * @note W/ \ref RING_BUFFER_DESC_NODE_ANY and \ref RING_BUFFER_DESC_MAP_PREFAULT, pages land on the node of the
+ *       calling thread: call it from a thread pinned next to the consumer.
+ *
+ * @param[out]     ptrRing     Ring buffer to initialize.
+ * @param          typeSize    Size of each element in bytes.
+ * @param          length      Number of slots (must be a power of two if \ref RING_BUFFER_POW2 is enabled).
+ * @param          flags       \ref RING_BUFFER_DESC_MAP_HUGE, \ref RING_BUFFER_DESC_MAP_HUGETLB and / or
+ *                             \ref RING_BUFFER_DESC_MAP_PREFAULT (0 for plain pages).
+ * @param          node        NUMA node to bind storage to (mbind), or \ref RING_BUFFER_DESC_NODE_ANY.
+ * @param[in]      ptrCallback Protect callback (if \ref RING_BUFFER_PROTECT is enabled, ignored otherwise).
+ * @param[in, out] ptrArg      Protect callback pointer to argument (if \ref RING_BUFFER_PROTECT is enabled).
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise (errno is set).
+ */
+RingBuffer_DescApi int32_t
+RingBuffer_DescMap (RingBuffer_Desc_t* ptrRing, uint32_t typeSize, uint32_t length, uint32_t flags, int32_t node,
+                    void (*ptrCallback)(uint8_t, void*), void* ptrArg);
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+
+/**
+ * Releases heap or mapped storage of a ring buffer (no-op for caller-provided storage).
+ *
+ * @param[in, out] ptrRing Ring buffer to release.
+ */
+RingBuffer_DescApi void
+RingBuffer_DescFree (RingBuffer_Desc_t* ptrRing);
+
+/**
+ * Resets ring buffer indexes.
+ *
+ * @param[in, out] ptrRing Ring buffer to reset.
+ */
+RingBuffer_DescApi void
+RingBuffer_DescReset (RingBuffer_Desc_t* ptrRing);
+
+/**
+ * Gets the number of usable slots.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return Length if \ref RING_BUFFER_POW2 is enabled, length - 1 otherwise.
+ */
+RingBuffer_DescApi uint32_t
+RingBuffer_DescGetCapacity (const RingBuffer_Desc_t* ptrRing);
+
+/**
+ * Gets the number of used slots.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The number of slots currently used.
+ */
+RingBuffer_DescApi uint32_t
+RingBuffer_DescGetUsed (RingBuffer_Desc_t* ptrRing);
+
+/**
+ * Gets the number of free slots.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The number of slots currently available.
+ */
+RingBuffer_DescApi uint32_t
+RingBuffer_DescGetFree (RingBuffer_Desc_t* ptrRing);
+
+/**
+ * Pushes single item into ring buffer.
+ *
+ * @note As for \ref RingBuffer_Push, the oldest item is overwritten if ring buffer is full, unless
+ *       \ref RING_BUFFER_SPSC is enabled: then the pushed item is discarded.
+ *
+ * @param[in, out] ptrRing Ring buffer to push to.
+ * @param[in]      ptrItem Item to push (typeSize bytes).
+ */
+RingBuffer_DescApi void
+RingBuffer_DescPush (RingBuffer_Desc_t* ptrRing, const void* ptrItem);
+
+/**
+ * Pops single item from ring buffer.
+ *
+ * @param[in, out] ptrRing Ring buffer to pop from.
+ * @param[out]     ptrItem Item to copy to the popped item (typeSize bytes).
+ *
+ * @return \ref RING_BUFFER_OK if popped, \ref RING_BUFFER_EMPTY if ring buffer is empty.
+ */
+RingBuffer_DescApi int32_t
+RingBuffer_DescPop (RingBuffer_Desc_t* ptrRing, void* ptrItem);
+
+/**
+ * Pushes up to size items into ring buffer w/ at most two memcpy.
+ *
+ * @param[in, out] ptrRing   Ring buffer to push to.
+ * @param[in]      ptrSource Linear buffer to copy data from.
+ * @param          size      Number of items to push.
+ *
+ * @return The number of items actually pushed.
+ */
+RingBuffer_DescApi uint32_t
+RingBuffer_DescPushBulk (RingBuffer_Desc_t* ptrRing, const void* ptrSource, uint32_t size);
+
+/**
+ * Pops up to size items from ring buffer w/ at most two memcpy.
+ *
+ * @param[in, out] ptrRing Ring buffer to pop from.
+ * @param[out]     ptrDest Linear buffer to copy data to.
+ * @param          size    Number of items to pop.
+ *
+ * @return The number of items actually popped.
+ */
+RingBuffer_DescApi uint32_t
+RingBuffer_DescPopBulk (RingBuffer_Desc_t* ptrRing, void* ptrDest, uint32_t size);
+
+/**
+ * Fills ring buffer with multiple items (asserts that all of them fit, as \ref RingBuffer_Fill).
+ *
+ * @param[in, out] ptrRing   Ring buffer to push to.
+ * @param[in]      ptrSource Linear buffer to copy data from.
+ * @param          size      Number of items to push.
+ */
+RingBuffer_DescApi void
+RingBuffer_DescFill (RingBuffer_Desc_t* ptrRing, const void* ptrSource, uint32_t size);
+
+/**
+ * Empties multiple items from ring buffer (asserts that all of them are available, as \ref RingBuffer_Empty).
+ *
+ * @param[in, out] ptrRing Ring buffer to pop from.
+ * @param[out]     ptrDest Linear buffer to copy data to.
+ * @param          size    Number of items to pop.
+ */
+RingBuffer_DescApi void
+RingBuffer_DescEmpty (RingBuffer_Desc_t* ptrRing, void* ptrDest, uint32_t size);
+
+#if (RING_BUFFER_DESC_DEFINE == 1)
+
+/**
+ * Gets the array slot of an index.
+ *
+ * @param[in] ptrRing Ring buffer.
+ * @param     index   Head or tail index.
+ *
+ * @return The slot number in [0, length).
+ */
+static inline uint32_t
+RingBuffer_DescGetSlot (const RingBuffer_Desc_t* ptrRing, uint32_t index)
+{
+#if (RING_BUFFER_POW2 == 1)
+    index &= (ptrRing->length - 1UL);
+#else
+    (void) ptrRing;
+#endif /* RING_BUFFER_POW2 == 1 */
+
+    return index;
+}
+
+/**
+ * Advances an index.
+ *
+ * @param[in] ptrRing Ring buffer.
+ * @param     index   Index to advance.
+ * @param     size    Number of slots to advance by.
+ *
+ * @return The advanced index.
+ */
+static inline uint32_t
+RingBuffer_DescAdvance (const RingBuffer_Desc_t* ptrRing, uint32_t index, uint32_t size)
+{
+#if (RING_BUFFER_POW2 == 1)
+    (void) ptrRing;
+#endif /* RING_BUFFER_POW2 == 1 */
+
+    RingBuffer_IncrementLinear (index, size, ptrRing->length);
+
+    return index;
+}
+
+/**
+ * Copies items from linear buffer into ring buffer slots, wrapping at the end of the storage.
+ *
+ * @param[in, out] ptrRing   Ring buffer.
+ * @param          index     First index to write.
+ * @param[in]      ptrSource Linear buffer to copy data from.
+ * @param          size      Number of items to copy.
+ */
+static inline void
+RingBuffer_DescCopyIn (RingBuffer_Desc_t* ptrRing, uint32_t index, const uint8_t* ptrSource, uint32_t size)
+{
+    uint32_t slot;
+    uint32_t first;
+
+    slot  = RingBuffer_DescGetSlot (ptrRing, index);
+    first = ((ptrRing->length - slot) < size) ? (ptrRing->length - slot) : size;
+
+    RingBuffer_CopyBytes (&ptrRing->ptrStorage[(size_t) slot * ptrRing->typeSize], ptrSource,
+                          ((size_t) first * ptrRing->typeSize));
+    RingBuffer_CopyBytes (ptrRing->ptrStorage, &ptrSource[(size_t) first * ptrRing->typeSize],
+                          ((size_t) (size - first) * ptrRing->typeSize));
+}
+
+/**
+ * Copies items from ring buffer slots into linear buffer, wrapping at the end of the storage.
+ *
+ * @param[in]  ptrRing Ring buffer.
+ * @param      index   First index to read.
+ * @param[out] ptrDest Linear buffer to copy data to.
+ * @param      size    Number of items to copy.
+ */
+static inline void
+RingBuffer_DescCopyOut (const RingBuffer_Desc_t* ptrRing, uint32_t index, uint8_t* ptrDest, uint32_t size)
+{
+    uint32_t slot;
+    uint32_t first;
+
+    slot  = RingBuffer_DescGetSlot (ptrRing, index);
+    first = ((ptrRing->length - slot) < size) ? (ptrRing->length - slot) : size;
+
+    (void) memcpy (ptrDest, &ptrRing->ptrStorage[(size_t) slot * ptrRing->typeSize],
+                   ((size_t) first * ptrRing->typeSize));
+    (void) memcpy (&ptrDest[(size_t) first * ptrRing->typeSize], ptrRing->ptrStorage,
+                   ((size_t) (size - first) * ptrRing->typeSize));
+}
+
+#if (RING_BUFFER_DESC_MAP == 1)
+/**
+ * Maps anonymous storage, w/ huge pages if requested.
+ *
+ * @param      size       Storage size in bytes.
+ * @param      flags      Map flags.
+ * @param[out] ptrMapSize Size actually mapped (rounded up to the page size).
+ *
+ * @return The storage, NULL on failure.
+ */
+static inline uint8_t*
+RingBuffer_DescMapPages (size_t size, uint32_t flags, size_t* ptrMapSize)
+{
+    uint8_t* ptrStorage;
+    void*    ptrMap;
+    size_t   huge;
+    size_t   page;
+    size_t   slack;
+
+    ptrStorage = NULL;
+    huge       = (size_t) RING_BUFFER_DESC_HUGE_PAGE_SIZE;
+
+    if ((flags & RING_BUFFER_DESC_MAP_HUGETLB) != 0U)
+    {
+        *ptrMapSize = ((size + huge) - 1U) & ~(huge - 1U);
+        ptrMap      = mmap (NULL, *ptrMapSize, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB),
+                            -1, 0);
+
+        if (ptrMap != MAP_FAILED)
+        {
+            ptrStorage = (uint8_t*) ptrMap;
+        }
+        else
+        {
+            /* Pool exhausted (or not configured): transparent huge pages are the next best thing. */
+            flags |= RING_BUFFER_DESC_MAP_HUGE;
+        }
+    }
+    else
+    {
+    }
+
+    if ((ptrStorage == NULL) && ((flags & RING_BUFFER_DESC_MAP_HUGE) != 0U))
+    {
+        /* Transparent huge pages only back aligned extents: over-map by one and trim both ends. */
+        *ptrMapSize = ((size + huge) - 1U) & ~(huge - 1U);
+        ptrMap      = mmap (NULL, (*ptrMapSize + huge), (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+
+        if (ptrMap != MAP_FAILED)
+        {
+            slack      = (huge - ((uintptr_t) ptrMap & (huge - 1U))) & (huge - 1U);
+            ptrStorage = &((uint8_t*) ptrMap)[slack];
+
+            if (slack != 0U)
+            {
+                (void) munmap (ptrMap, slack);
+            }
+            else
+            {
+            }
+
+            (void) munmap (&ptrStorage[*ptrMapSize], (huge - slack));
+
+            /* Advisory: fails harmlessly if transparent huge pages are disabled. */
+            (void) madvise (ptrStorage, *ptrMapSize, MADV_HUGEPAGE);
+        }
+        else
+        {
+        }
+    }
+    else if (ptrStorage == NULL)
+    {
+        page        = (size_t) sysconf (_SC_PAGESIZE);
+        *ptrMapSize = ((size + page) - 1U) & ~(page - 1U);
+        ptrMap      = mmap (NULL, *ptrMapSize, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+        ptrStorage  = (ptrMap != MAP_FAILED) ? (uint8_t*) ptrMap : NULL;
+    }
+    else
+    {
+    }
+
+    return ptrStorage;
+}
+
+/**
+ * Binds storage to a NUMA node: pages are allocated there whichever thread touches them first.
+ *
+ * @param[in] ptrStorage Storage.
+ * @param     size       Storage size in bytes.
+ * @param     node       NUMA node.
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise (errno is set).
+ */
+static inline int32_t
+RingBuffer_DescBind (void* ptrStorage, size_t size, int32_t node)
+{
+    unsigned long mask[RING_BUFFER_DESC_NODE_MAX / (CHAR_BIT * sizeof (unsigned long))];
+    size_t        bits;
+    int32_t       res;
+
+    res  = RING_BUFFER_ERROR;
+    bits = CHAR_BIT * sizeof (unsigned long);
+
+    if ((node >= 0) && (node < RING_BUFFER_DESC_NODE_MAX))
+    {
+        (void) memset (mask, 0x00, sizeof (mask));
+
+        mask[(size_t) node / bits] = 1UL << ((size_t) node % bits);
+
+        /* The kernel reads maxnode - 1 bits. */
+        if (syscall (SYS_mbind, ptrStorage, size, MPOL_BIND, mask, (unsigned long) RING_BUFFER_DESC_NODE_MAX + 1UL,
+                     0U) == 0L)
+        {
+            res = RING_BUFFER_OK;
+        }
+        else
+        {
+        }
+    }
+    else
+    {
+        errno = EINVAL;
+    }
+
+    return res;
+}
+
+/**
+ * Faults every page of storage in, so the hot path does not.
+ *
+ * @param[in, out] ptrStorage Storage (zero-filled, left unchanged).
+ * @param          size       Storage size in bytes.
+ */
+static inline void
+RingBuffer_DescPrefault (uint8_t* ptrStorage, size_t size)
+{
+    volatile uint8_t* ptrPage;
+    size_t            pageSize;
+    size_t            offset;
+    int               res;
+
+    res = -1;
+
+#if defined (MADV_POPULATE_WRITE)
+    res = madvise (ptrStorage, size, MADV_POPULATE_WRITE);
+#endif /* MADV_POPULATE_WRITE */
+
+    if (res != 0)
+    {
+        /* Older kernels: one write per page. */
+        ptrPage  = ptrStorage;
+        pageSize = (size_t) sysconf (_SC_PAGESIZE);
+
+        for (offset = 0U; offset < size; offset += pageSize)
+        {
+            ptrPage[offset] = 0U;
+        }
+    }
+    else
+    {
+    }
+}
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+
+RingBuffer_DescApi void
+RingBuffer_DescInit (RingBuffer_Desc_t* ptrRing, void* ptrStorage, uint32_t typeSize, uint32_t length,
+                     void (*ptrCallback)(uint8_t, void*), void* ptrArg)
+{
+    RingBuffer_Assert ((ptrRing != NULL) && (ptrStorage != NULL) && (typeSize > 0UL) && (length > 1UL));
+#if (RING_BUFFER_POW2 == 1)
+    RingBuffer_Assert ((length & (length - 1UL)) == 0UL);
+#endif /* RING_BUFFER_POW2 == 1 */
+
+    ptrRing->ptrStorage = ptrStorage;
+    ptrRing->typeSize   = typeSize;
+    ptrRing->length     = length;
+    ptrRing->owned      = 0U;
+
+#if (RING_BUFFER_PROTECT == 1)
+    ptrRing->protect.ptrCallback = ptrCallback;
+    ptrRing->protect.ptrArg      = ptrArg;
+#else
+    (void) ptrCallback;
+    (void) ptrArg;
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+    RingBuffer_DescReset (ptrRing);
+}
+
+RingBuffer_DescApi int32_t
+RingBuffer_DescAlloc (RingBuffer_Desc_t* ptrRing, uint32_t typeSize, uint32_t length,
+                      void (*ptrCallback)(uint8_t, void*), void* ptrArg)
+{
+    int32_t res;
+    void*   ptrStorage;
+
+    res        = RING_BUFFER_ERROR;
+    ptrStorage = malloc (RingBuffer_DescGetStorageSize (typeSize, length));
+
+    if (ptrStorage != NULL)
+    {
+        RingBuffer_DescInit (ptrRing, ptrStorage, typeSize, length, ptrCallback, ptrArg);
+
+        ptrRing->owned = 1U;
+
+        res = RING_BUFFER_OK;
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+#if (RING_BUFFER_DESC_MAP == 1)
+RingBuffer_DescApi int32_t
+RingBuffer_DescMap (RingBuffer_Desc_t* ptrRing, uint32_t typeSize, uint32_t length, uint32_t flags, int32_t node,
+                    void (*ptrCallback)(uint8_t, void*), void* ptrArg)
+{
+    int32_t  res;
+    int      error;
+    uint8_t* ptrStorage;
+    size_t   mapSize;
+
+    res        = RING_BUFFER_ERROR;
+    mapSize    = 0U;
+    ptrStorage = RingBuffer_DescMapPages (RingBuffer_DescGetStorageSize (typeSize, length), flags, &mapSize);
+
+    if (ptrStorage == NULL)
+    {
+    }
+    else if ((node != RING_BUFFER_DESC_NODE_ANY) && (RingBuffer_DescBind (ptrStorage, mapSize, node) != RING_BUFFER_OK))
+    {
+        error = errno;
+
+        (void) munmap (ptrStorage, mapSize);
+
+        errno = error;
+    }
+    else
+    {
+        /* After madvise / mbind, so that the faulted pages are huge and on the right node. */
+        if ((flags & RING_BUFFER_DESC_MAP_PREFAULT) != 0U)
+        {
+            RingBuffer_DescPrefault (ptrStorage, mapSize);
+        }
+        else
+        {
+        }
+
+        RingBuffer_DescInit (ptrRing, ptrStorage, typeSize, length, ptrCallback, ptrArg);
+
+        ptrRing->owned   = 2U;
+        ptrRing->mapSize = mapSize;
+
+        res = RING_BUFFER_OK;
+    }
+
+    return res;
+}
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+
+RingBuffer_DescApi void
+RingBuffer_DescFree (RingBuffer_Desc_t* ptrRing)
+{
+    RingBuffer_Assert (ptrRing != NULL);
+
+    if (ptrRing->owned == 1U)
+    {
+        free (ptrRing->ptrStorage);
+    }
+#if (RING_BUFFER_DESC_MAP == 1)
+    else if (ptrRing->owned == 2U)
+    {
+        (void) munmap (ptrRing->ptrStorage, ptrRing->mapSize);
+    }
+#endif /* RING_BUFFER_DESC_MAP == 1 */
+    else
+    {
+    }
+
+    ptrRing->ptrStorage = NULL;
+    ptrRing->owned      = 0U;
+}
+
+RingBuffer_DescApi void
+RingBuffer_DescReset (RingBuffer_Desc_t* ptrRing)
+{
+    RingBuffer_DescStore (ptrRing->head, 0U, memory_order_relaxed);
+    RingBuffer_DescStore (ptrRing->tail, 0U, memory_order_relaxed);
+}
+
+RingBuffer_DescApi uint32_t
+RingBuffer_DescGetCapacity (const RingBuffer_Desc_t* ptrRing)
+{
+#if (RING_BUFFER_POW2 == 1)
+    return ptrRing->length;
+#else
+    return ptrRing->length - 1UL;
+#endif /* RING_BUFFER_POW2 == 1 */
+}
+
+RingBuffer_DescApi uint32_t
+RingBuffer_DescGetUsed (RingBuffer_Desc_t* ptrRing)
+{
+    return RingBuffer_Distance (RingBuffer_DescLoad (ptrRing->head, memory_order_acquire),
+                                RingBuffer_DescLoad (ptrRing->tail, memory_order_acquire),
+                                ptrRing->length);
+}
+
+RingBuffer_DescApi uint32_t
+RingBuffer_DescGetFree (RingBuffer_Desc_t* ptrRing)
+{
+    return RingBuffer_DescGetCapacity (ptrRing) - RingBuffer_DescGetUsed (ptrRing);
+}
+
+RingBuffer_DescApi void
+RingBuffer_DescPush (RingBuffer_Desc_t* ptrRing, const void* ptrItem)
+{
+#if (RING_BUFFER_SPSC == 1)
+    (void) RingBuffer_DescPushBulk (ptrRing, ptrItem, 1UL);
+#else
+    uint32_t head;
+
+    RingBuffer_Protect (RING_BUFFER_LOCK, ptrRing->protect.ptrCallback, ptrRing->protect.ptrArg);
+
+    head = ptrRing->head;
+
+    RingBuffer_DescCopyIn (ptrRing, head, ptrItem, 1UL);
+
+    ptrRing->head = RingBuffer_DescAdvance (ptrRing, head, 1UL);
+
+    /* Overwrite the oldest item if ring buffer was full. */
+#if (RING_BUFFER_POW2 == 1)
+    if ((ptrRing->head - ptrRing->tail) > ptrRing->length)
+#else
+    if (ptrRing->head == ptrRing->tail)
+#endif /* RING_BUFFER_POW2 == 1 */
+    {
+        ptrRing->tail = RingBuffer_DescAdvance (ptrRing, ptrRing->tail, 1UL);
+    }
+    else
+    {
+    }
+
+    RingBuffer_Protect (RING_BUFFER_UNLOCK, ptrRing->protect.ptrCallback, ptrRing->protect.ptrArg);
+#endif /* RING_BUFFER_SPSC == 1 */
+}
+
+RingBuffer_DescApi int32_t
+RingBuffer_DescPop (RingBuffer_Desc_t* ptrRing, void* ptrItem)
+{
+    return (RingBuffer_DescPopBulk (ptrRing, ptrItem, 1UL) == 1UL) ? RING_BUFFER_OK : RING_BUFFER_EMPTY;
+}
+
+RingBuffer_DescApi uint32_t
+RingBuffer_DescPushBulk (RingBuffer_Desc_t* ptrRing, const void* ptrSource, uint32_t size)
+{
+    uint32_t head;
+    uint32_t available;
+
+    RingBuffer_Protect (RING_BUFFER_LOCK, ptrRing->protect.ptrCallback, ptrRing->protect.ptrArg);
+
+    head      = RingBuffer_DescLoad (ptrRing->head, memory_order_relaxed);
+    available = RingBuffer_DescGetCapacity (ptrRing) -
+                RingBuffer_Distance (head, RingBuffer_DescLoad (ptrRing->tail, memory_order_acquire),
+                                     ptrRing->length);
+
+    if (size < available)
+    {
+        available = size;
+    }
+    else
+    {
+    }
+
+    RingBuffer_DescCopyIn (ptrRing, head, ptrSource, available);
+
+    RingBuffer_DescStore (ptrRing->head, RingBuffer_DescAdvance (ptrRing, head, available), memory_order_release);
+
+    RingBuffer_Protect (RING_BUFFER_UNLOCK, ptrRing->protect.ptrCallback, ptrRing->protect.ptrArg);
+
+    return available;
+}
+
+RingBuffer_DescApi uint32_t
+RingBuffer_DescPopBulk (RingBuffer_Desc_t* ptrRing, void* ptrDest, uint32_t size)
+{
+    uint32_t tail;
+    uint32_t used;
+
+    RingBuffer_Protect (RING_BUFFER_LOCK, ptrRing->protect.ptrCallback, ptrRing->protect.ptrArg);
+
+    tail = RingBuffer_DescLoad (ptrRing->tail, memory_order_relaxed);
+    used = RingBuffer_Distance (RingBuffer_DescLoad (ptrRing->head, memory_order_acquire), tail, ptrRing->length);
+
+    if (size < used)
+    {
+        used = size;
+    }
+    else
+    {
+    }
+
+    RingBuffer_DescCopyOut (ptrRing, tail, ptrDest, used);
+
+    RingBuffer_DescStore (ptrRing->tail, RingBuffer_DescAdvance (ptrRing, tail, used), memory_order_release);
+
+    RingBuffer_Protect (RING_BUFFER_UNLOCK, ptrRing->protect.ptrCallback, ptrRing->protect.ptrArg);
+
+    return used;
+}
+
+RingBuffer_DescApi void
+RingBuffer_DescFill (RingBuffer_Desc_t* ptrRing, const void* ptrSource, uint32_t size)
+{
+    uint32_t count;
+
+    count = RingBuffer_DescPushBulk (ptrRing, ptrSource, size);
+
+    RingBuffer_Assert (count == size);
+
+    (void) count;
+}
+
+RingBuffer_DescApi void
+RingBuffer_DescEmpty (RingBuffer_Desc_t* ptrRing, void* ptrDest, uint32_t size)
+{
+    uint32_t count;
+
+    count = RingBuffer_DescPopBulk (ptrRing, ptrDest, size);
+
+    RingBuffer_Assert (count == size);
+
+    (void) count;
+}
+
+#endif /* RING_BUFFER_DESC_DEFINE == 1 */
+
+#endif /* RING_BUFFER_DESC_H__ */
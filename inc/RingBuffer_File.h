@@ -0,0 +1,483 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_File.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only file-backed flight recorder util: an overwrite-oldest ring buffer in a mapped file (POSIX).
+ *
+ * The file starts w/ a header (magic, version, element size, length and the tail / head sequence numbers) followed by
+ * the slots, so the last records survive a crash of the writer and can be recovered in order after a restart or by a
+ * post-mortem tool. Appending is a memcpy into the shared mapping, w/o any system call: the page cache keeps the data
+ * if the process dies, \ref RingBuffer_FileSync flushes it to disk (e.g. to survive a power loss) on demand.
+ *
+ * Sequence numbers count the records ever appended, records in [tail, head) are recoverable. The tail is moved past
+ * a slot before the slot is overwritten and the head is moved once the record is written, so a record torn by a
+ * crash is never within [tail, head).
+ *
+ * @note A single process appends at a time.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_FILE_H__
+#define RING_BUFFER_FILE_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+/* System includes. */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/**
+ * Flight recorder file magic ("RBFR"), published last once the file is initialized.
+ */
+#define RING_BUFFER_FILE_MAGIC 0x52424652UL
+
+/**
+ * Flight recorder file layout version, bumped on any change of \ref RingBuffer_FileHeader_t.
+ */
+#define RING_BUFFER_FILE_VERSION 1UL
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/**
+ * Flight recorder file header, at offset 0 of the file (slots follow it).
+ */
+typedef struct
+{
+    _Atomic uint32_t magic;      /**< \ref RING_BUFFER_FILE_MAGIC once ready. */
+    uint32_t         version;    /**< \ref RING_BUFFER_FILE_VERSION. */
+    uint32_t         headerSize; /**< Offset of the first slot in bytes. */
+    uint32_t         typeSize;   /**< Size of each record in bytes. */
+    uint32_t         length;     /**< Number of slots. */
+    uint32_t         reserved;   /**< Keeps the sequence numbers 8-byte aligned. */
+    _Atomic uint64_t tail;       /**< Sequence number of the oldest recoverable record. */
+    _Atomic uint64_t head;       /**< Sequence number of the next record (records ever appended). */
+} RingBuffer_FileHeader_t;
+
+/**
+ * Flight recorder handle, local to each process.
+ */
+typedef struct
+{
+    RingBuffer_FileHeader_t* ptrHeader; /**< Mapped file. */
+    uint8_t*                 ptrBuffer; /**< First slot. */
+    size_t                   size;      /**< Size of the mapping in bytes. */
+    int                      fd;        /**< File descriptor. */
+    uint32_t                 typeSize;  /**< Validated size of each record in bytes. */
+    uint32_t                 length;    /**< Validated number of slots. */
+    uint32_t                 slot;      /**< Writer slot of head. */
+    uint64_t                 tail;      /**< Writer copy of tail. */
+    uint64_t                 head;      /**< Writer copy of head. */
+    uint64_t                 synced;    /**< Head at the last \ref RingBuffer_FileSync. */
+} RingBuffer_File_t;
+
+_Static_assert (ATOMIC_LLONG_LOCK_FREE == 2, "Flight recorder sequence numbers must be lock-free");
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+/**
+ * Maps a flight recorder file and validates its header.
+ *
+ * @param[out] ptrRing Flight recorder handle.
+ * @param      fd      File descriptor (owned by the handle on success).
+ * @param      prot    Mapping protection (PROT_READ, optionally PROT_WRITE).
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise (e.g. not initialized, version mismatch).
+ */
+static inline int32_t
+RingBuffer_FileMap (RingBuffer_File_t* ptrRing, int fd, int prot)
+{
+    int32_t                  res;
+    uint64_t                 tail;
+    uint64_t                 head;
+    struct stat              info;
+    RingBuffer_FileHeader_t* ptrHeader;
+
+    RingBuffer_Assert (ptrRing != NULL);
+
+    res       = RING_BUFFER_ERROR;
+    ptrHeader = MAP_FAILED;
+
+    if ((fd >= 0) && (fstat (fd, &info) == 0) && (info.st_size >= (off_t) sizeof (RingBuffer_FileHeader_t)))
+    {
+        ptrHeader = mmap (NULL, (size_t) info.st_size, prot, MAP_SHARED, fd, 0);
+    }
+    else
+    {
+    }
+
+    if (ptrHeader != MAP_FAILED)
+    {
+        /* The file may come from a crashed writer or another build: geometry and indexes are checked once. */
+        tail = atomic_load_explicit (&ptrHeader->tail, memory_order_acquire);
+        head = atomic_load_explicit (&ptrHeader->head, memory_order_acquire);
+
+        if ((atomic_load_explicit (&ptrHeader->magic, memory_order_acquire) == RING_BUFFER_FILE_MAGIC) &&
+            (ptrHeader->version == RING_BUFFER_FILE_VERSION) &&
+            (ptrHeader->headerSize == sizeof (RingBuffer_FileHeader_t)) &&
+            (ptrHeader->typeSize > 0UL) && (ptrHeader->length > 0UL) &&
+            (((uint64_t) ptrHeader->typeSize * ptrHeader->length) <=
+             ((uint64_t) info.st_size - sizeof (RingBuffer_FileHeader_t))) &&
+            (tail <= head) && ((head - tail) <= ptrHeader->length))
+        {
+            ptrRing->ptrHeader = ptrHeader;
+            ptrRing->ptrBuffer = &((uint8_t*) ptrHeader)[sizeof (RingBuffer_FileHeader_t)];
+            ptrRing->size      = (size_t) info.st_size;
+            ptrRing->fd        = fd;
+            ptrRing->typeSize  = ptrHeader->typeSize;
+            ptrRing->length    = ptrHeader->length;
+            ptrRing->slot      = (uint32_t) (head % ptrHeader->length);
+            ptrRing->tail      = tail;
+            ptrRing->head      = head;
+            ptrRing->synced    = head;
+
+            res = RING_BUFFER_OK;
+        }
+        else
+        {
+            (void) munmap (ptrHeader, (size_t) info.st_size);
+        }
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Opens a flight recorder file for appending: the records of a previous run are kept (and can be recovered before
+ * appending) if the file has the same geometry, otherwise the file is created or reset.
+ *
+ * @param[out] ptrRing  Flight recorder handle.
+ * @param[in]  ptrPath  File path.
+ * @param      typeSize Size of each record in bytes.
+ * @param      length   Number of records kept.
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise.
+ */
+static inline int32_t
+RingBuffer_FileOpen (RingBuffer_File_t* ptrRing, const char* ptrPath, uint32_t typeSize, uint32_t length)
+{
+    int32_t                  res;
+    int                      fd;
+    uint64_t                 size;
+    RingBuffer_FileHeader_t* ptrHeader;
+
+    RingBuffer_Assert ((ptrRing != NULL) && (ptrPath != NULL) && (typeSize > 0UL) && (length > 0UL));
+
+    size = sizeof (RingBuffer_FileHeader_t) + ((uint64_t) typeSize * length);
+    fd   = open (ptrPath, (O_RDWR | O_CREAT | O_CLOEXEC), (S_IRUSR | S_IWUSR));
+    res  = RingBuffer_FileMap (ptrRing, fd, (PROT_READ | PROT_WRITE));
+
+    if ((res == RING_BUFFER_OK) && ((ptrRing->typeSize != typeSize) || (ptrRing->length != length)))
+    {
+        (void) munmap (ptrRing->ptrHeader, ptrRing->size);
+
+        res = RING_BUFFER_ERROR;
+    }
+    else
+    {
+    }
+
+    /* Truncating first zeroes the magic, so a crash while initializing leaves no valid header behind. */
+    if ((res != RING_BUFFER_OK) && (fd >= 0) && (size <= (uint64_t) SIZE_MAX) && (ftruncate (fd, 0) == 0) &&
+        (ftruncate (fd, (off_t) size) == 0))
+    {
+        ptrHeader = mmap (NULL, (size_t) size, (PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0);
+
+        if (ptrHeader != MAP_FAILED)
+        {
+            ptrHeader->version    = RING_BUFFER_FILE_VERSION;
+            ptrHeader->headerSize = sizeof (RingBuffer_FileHeader_t);
+            ptrHeader->typeSize   = typeSize;
+            ptrHeader->length     = length;
+            ptrHeader->reserved   = 0U;
+
+            atomic_init (&ptrHeader->tail, 0U);
+            atomic_init (&ptrHeader->head, 0U);
+
+            /* Readers that see the magic see the whole header. */
+            atomic_store_explicit (&ptrHeader->magic, RING_BUFFER_FILE_MAGIC, memory_order_release);
+
+            (void) munmap (ptrHeader, (size_t) size);
+
+            res = RingBuffer_FileMap (ptrRing, fd, (PROT_READ | PROT_WRITE));
+        }
+        else
+        {
+        }
+    }
+    else
+    {
+    }
+
+    if ((res != RING_BUFFER_OK) && (fd >= 0))
+    {
+        (void) close (fd);
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Opens a flight recorder file read-only (e.g. in a post-mortem tool).
+ *
+ * @note Records are stable only once the writer stopped: a live writer may overwrite the oldest ones meanwhile.
+ *
+ * @param[out] ptrRing Flight recorder handle.
+ * @param[in]  ptrPath File path.
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise (e.g. missing or invalid file).
+ */
+static inline int32_t
+RingBuffer_FileAttach (RingBuffer_File_t* ptrRing, const char* ptrPath)
+{
+    int32_t res;
+    int     fd;
+
+    RingBuffer_Assert (ptrPath != NULL);
+
+    fd  = open (ptrPath, (O_RDONLY | O_CLOEXEC));
+    res = RingBuffer_FileMap (ptrRing, fd, PROT_READ);
+
+    if ((res != RING_BUFFER_OK) && (fd >= 0))
+    {
+        (void) close (fd);
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Closes a flight recorder file (records are kept in the page cache, see \ref RingBuffer_FileSync for the disk).
+ *
+ * @param[in, out] ptrRing Flight recorder handle.
+ */
+static inline void
+RingBuffer_FileClose (RingBuffer_File_t* ptrRing)
+{
+    RingBuffer_Assert (ptrRing != NULL);
+
+    (void) munmap (ptrRing->ptrHeader, ptrRing->size);
+    (void) close (ptrRing->fd);
+
+    ptrRing->ptrHeader = NULL;
+    ptrRing->ptrBuffer = NULL;
+    ptrRing->fd        = -1;
+}
+
+/**
+ * Appends up to length records to a flight recorder, overwriting the oldest ones, w/ at most two memcpy.
+ *
+ * @note If size exceeds the length, only the newest length records are appended (the others get no sequence number).
+ *
+ * @param[in, out] ptrRing   Flight recorder to append to.
+ * @param[in]      ptrSource Linear buffer to copy records from.
+ * @param          size      Number of records to append.
+ */
+static inline void
+RingBuffer_FileAppendBulk (RingBuffer_File_t* ptrRing, const void* ptrSource, uint32_t size)
+{
+    uint32_t skip;
+    uint32_t first;
+
+    skip = (size > ptrRing->length) ? (size - ptrRing->length) : 0U;
+    size = size - skip;
+
+    /* Give up the slots about to be overwritten before touching them. */
+    if (((ptrRing->head + size) - ptrRing->tail) > ptrRing->length)
+    {
+        ptrRing->tail = (ptrRing->head + size) - ptrRing->length;
+
+        atomic_store_explicit (&ptrRing->ptrHeader->tail, ptrRing->tail, memory_order_relaxed);
+        atomic_thread_fence (memory_order_release);
+    }
+    else
+    {
+    }
+
+    first = ((ptrRing->length - ptrRing->slot) < size) ? (ptrRing->length - ptrRing->slot) : size;
+
+    (void) memcpy (&ptrRing->ptrBuffer[(size_t) ptrRing->slot * ptrRing->typeSize],
+                   &((const uint8_t*) ptrSource)[(size_t) skip * ptrRing->typeSize],
+                   ((size_t) first * ptrRing->typeSize));
+    (void) memcpy (ptrRing->ptrBuffer, &((const uint8_t*) ptrSource)[(size_t) (skip + first) * ptrRing->typeSize],
+                   ((size_t) (size - first) * ptrRing->typeSize));
+
+    ptrRing->head += size;
+    ptrRing->slot  = ((ptrRing->slot + size) >= ptrRing->length) ? ((ptrRing->slot + size) - ptrRing->length) :
+                                                                     (ptrRing->slot + size);
+
+    atomic_store_explicit (&ptrRing->ptrHeader->head, ptrRing->head, memory_order_release);
+}
+
+/**
+ * Appends single record to a flight recorder, overwriting the oldest one if full.
+ *
+ * @param[in, out] ptrRing Flight recorder to append to.
+ * @param[in]      ptrItem Record to append.
+ */
+static inline void
+RingBuffer_FileAppend (RingBuffer_File_t* ptrRing, const void* ptrItem)
+{
+    RingBuffer_FileAppendBulk (ptrRing, ptrItem, 1U);
+}
+
+/**
+ * Flushes the records appended since the last call, then the header, to disk.
+ *
+ * @note Batch appends between calls: only the dirty pages of the slots are flushed.
+ *
+ * @param[in, out] ptrRing Flight recorder to flush.
+ * @param          wait    0 to schedule the write-back (MS_ASYNC), 1 to wait for it (MS_SYNC).
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise.
+ */
+static inline int32_t
+RingBuffer_FileSync (RingBuffer_File_t* ptrRing, uint8_t wait)
+{
+    int32_t  res;
+    int      flags;
+    size_t   page;
+    size_t   start[3];
+    size_t   end[3];
+    uint32_t i;
+    uint32_t slot;
+    uint32_t first;
+    uint64_t pending;
+
+    flags   = (wait != 0U) ? MS_SYNC : MS_ASYNC;
+    page    = (size_t) sysconf (_SC_PAGESIZE);
+    pending = ptrRing->head - ptrRing->synced;
+    pending = (pending < ptrRing->length) ? pending : ptrRing->length;
+    slot    = (uint32_t) ((ptrRing->head - pending) % ptrRing->length);
+    first   = ((ptrRing->length - slot) < pending) ? (ptrRing->length - slot) : (uint32_t) pending;
+
+    /* Byte ranges of the dirty slots (at most two), then of the header: it lands last. */
+    start[0] = sizeof (RingBuffer_FileHeader_t) + ((size_t) slot * ptrRing->typeSize);
+    end[0]   = start[0] + ((size_t) first * ptrRing->typeSize);
+    start[1] = sizeof (RingBuffer_FileHeader_t);
+    end[1]   = start[1] + ((size_t) (pending - first) * ptrRing->typeSize);
+    start[2] = 0U;
+    end[2]   = sizeof (RingBuffer_FileHeader_t);
+    res      = RING_BUFFER_OK;
+
+    for (i = 0U; (i < 3U) && (res == RING_BUFFER_OK); i++)
+    {
+        start[i] -= (start[i] % page);
+
+        if ((end[i] > start[i]) &&
+            (msync (&((uint8_t*) ptrRing->ptrHeader)[start[i]], (end[i] - start[i]), flags) != 0))
+        {
+            res = RING_BUFFER_ERROR;
+        }
+        else
+        {
+        }
+    }
+
+    if (res == RING_BUFFER_OK)
+    {
+        ptrRing->synced = ptrRing->head;
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Gets the number of recoverable records of a flight recorder.
+ *
+ * @param[in] ptrRing Flight recorder.
+ *
+ * @return The number of records, at most the length.
+ */
+static inline uint32_t
+RingBuffer_FileGetCount (const RingBuffer_File_t* ptrRing)
+{
+    uint64_t tail;
+    uint64_t head;
+
+    tail = atomic_load_explicit (&ptrRing->ptrHeader->tail, memory_order_acquire);
+    head = atomic_load_explicit (&ptrRing->ptrHeader->head, memory_order_acquire);
+
+    /* Indexes come from a file: never report more than the length. */
+    return ((tail <= head) && ((head - tail) <= ptrRing->length)) ? (uint32_t) (head - tail) : 0U;
+}
+
+/**
+ * Gets the sequence number of the oldest recoverable record of a flight recorder.
+ *
+ * @param[in] ptrRing Flight recorder.
+ *
+ * @return The sequence number of the oldest record (records ever overwritten).
+ */
+static inline uint64_t
+RingBuffer_FileGetFirst (const RingBuffer_File_t* ptrRing)
+{
+    return atomic_load_explicit (&ptrRing->ptrHeader->tail, memory_order_acquire);
+}
+
+/**
+ * Gets a recoverable record of a flight recorder in place, in append order.
+ *
+ * @param[in] ptrRing Flight recorder.
+ * @param     index   Record index, from 0 (oldest) to \ref RingBuffer_FileGetCount - 1 (newest).
+ *
+ * @return Pointer to the record in the mapping, NULL if index is out of range.
+ */
+static inline const void*
+RingBuffer_FileGetRecord (const RingBuffer_File_t* ptrRing, uint32_t index)
+{
+    const void* ptrRecord;
+
+    ptrRecord = NULL;
+
+    if (index < RingBuffer_FileGetCount (ptrRing))
+    {
+        ptrRecord = &ptrRing->ptrBuffer[(size_t) ((RingBuffer_FileGetFirst (ptrRing) + index) % ptrRing->length) *
+                                        ptrRing->typeSize];
+    }
+    else
+    {
+    }
+
+    return ptrRecord;
+}
+
+#endif /* RING_BUFFER_FILE_H__ */
@@ -0,0 +1,270 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Io.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only scatter / gather I/O util: moves bytes between a file descriptor and a byte ring buffer in place.
+ *
+ * The used (or free) slots of a ring buffer are at most two contiguous spans: they are passed as an iovec array to
+ * writev / sendmsg (or readv / recvmsg), so data goes from the ring buffer to the kernel (and back) w/o any
+ * intermediate linear buffer. Indexes advance by the bytes actually transferred, partial transfers included.
+ *
+ * @note The ring buffer elements must be bytes (e.g. uint8_t). Only one I/O per direction at a time is allowed (see
+ *       \ref RingBuffer_Peek and \ref RingBuffer_Reserve).
+ * @warning Writes / sends go through \ref RingBuffer_Peek: w/ the \ref RING_BUFFER_OVERWRITE policy (unless
+ *          \ref RING_BUFFER_SPSC is enabled), a concurrent push on a full ring buffer may overwrite bytes while the
+ *          kernel is copying them. Use \ref RING_BUFFER_REJECT, \ref RING_BUFFER_DROP or \ref RING_BUFFER_BLOCK
+ *          when producers run concurrently.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_IO_H__
+#define RING_BUFFER_IO_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+/* System includes. */
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/**
+ * Checks that a ring buffer holds bytes.
+ *
+ * @param pName Ring buffer variable name.
+ */
+#define RingBuffer_IoCheck(pName) \
+    RingBuffer_Assert (RingBuffer_GetTypeSize ((pName)) == 1U)
+
+/**
+ * Gets the number of non-empty spans.
+ *
+ * @param      pFirstSize  Number of bytes in the first span.
+ * @param      pSecondSize Number of bytes in the second span.
+ * @param[out] pCount      Number of spans (0, 1 or 2).
+ */
+#define RingBuffer_IoGetCount(pFirstSize, pSecondSize, pCount) \
+    if ((pSecondSize) > 0U)                                    \
+    {                                                          \
+        (pCount) = 2;                                          \
+    }                                                          \
+    else if ((pFirstSize) > 0U)                                \
+    {                                                          \
+        (pCount) = 1;                                          \
+    }                                                          \
+    else                                                       \
+    {                                                          \
+        (pCount) = 0;                                          \
+    }
+
+/**
+ * Describes the used bytes of a ring buffer as an iovec array, to be sent (e.g. w/ io_uring or a TLS library).
+ *
+ * @note Bytes are not freed until \ref RingBuffer_Release is called w/ the number of bytes actually sent.
+ *
+ * @param      pName  Ring buffer to read from.
+ * @param[out] pIov   Array of (at least) 2 struct iovec.
+ * @param[out] pCount Number of iovec filled (0 if ring buffer is empty).
+ */
+#define RingBuffer_IoPeek(pName, pIov, pCount)                                       \
+{                                                                                    \
+    uint32_t firstSize;                                                              \
+    uint32_t secondSize;                                                             \
+    RingBuffer_IoCheck ((pName));                                                    \
+    RingBuffer_Peek ((pName), RingBuffer_GetCapacity ((pName)),                      \
+                     (pIov)[0].iov_base, firstSize, (pIov)[1].iov_base, secondSize); \
+    (pIov)[0].iov_len = firstSize;                                                   \
+    (pIov)[1].iov_len = secondSize;                                                  \
+    RingBuffer_IoGetCount (firstSize, secondSize, (pCount));                         \
+}
+
+/**
+ * Describes the free bytes of a ring buffer as an iovec array, to be received into.
+ *
+ * @note Bytes are not visible to the consumer until \ref RingBuffer_Commit is called w/ the number of bytes actually
+ *       received.
+ *
+ * @param      pName  Ring buffer to write to.
+ * @param[out] pIov   Array of (at least) 2 struct iovec.
+ * @param[out] pCount Number of iovec filled (0 if ring buffer is full).
+ */
+#define RingBuffer_IoReserve(pName, pIov, pCount)                                       \
+{                                                                                       \
+    uint32_t firstSize;                                                                 \
+    uint32_t secondSize;                                                                \
+    RingBuffer_IoCheck ((pName));                                                       \
+    RingBuffer_Reserve ((pName), RingBuffer_GetCapacity ((pName)),                      \
+                        (pIov)[0].iov_base, firstSize, (pIov)[1].iov_base, secondSize); \
+    (pIov)[0].iov_len = firstSize;                                                      \
+    (pIov)[1].iov_len = secondSize;                                                     \
+    RingBuffer_IoGetCount (firstSize, secondSize, (pCount));                            \
+}
+
+/**
+ * Writes the used bytes of a ring buffer to a file descriptor w/ a single writev, freeing the bytes written.
+ *
+ * @warning Not safe against concurrent overwriting pushes (see \ref RingBuffer_Peek).
+ *
+ * @param      pName   Ring buffer to read from.
+ * @param      pFd     File descriptor (e.g. socket, pipe, file).
+ * @param[out] pResult Bytes written (ssize_t), 0 if ring buffer is empty, -1 on error (see errno, e.g. EAGAIN).
+ */
+#define RingBuffer_WriteFd(pName, pFd, pResult) \
+{                                               \
+    struct iovec iov[2];                        \
+    int          count;                         \
+    RingBuffer_IoPeek ((pName), iov, count);    \
+    if (count > 0)                              \
+    {                                           \
+        (pResult) = writev ((pFd), iov, count); \
+    }                                           \
+    else                                        \
+    {                                           \
+        (pResult) = 0;                          \
+    }                                           \
+    RingBuffer_IoRelease ((pName), (pResult));  \
+}
+
+/**
+ * Reads from a file descriptor into the free bytes of a ring buffer w/ a single readv, committing the bytes read.
+ *
+ * @param      pName   Ring buffer to write to.
+ * @param      pFd     File descriptor (e.g. socket, pipe, file).
+ * @param[out] pResult Bytes read (ssize_t), 0 at end of file, -1 on error (see errno, e.g. EAGAIN, or ENOBUFS if ring
+ *                     buffer is full).
+ */
+#define RingBuffer_ReadFd(pName, pFd, pResult)  \
+{                                               \
+    struct iovec iov[2];                        \
+    int          count;                         \
+    RingBuffer_IoReserve ((pName), iov, count); \
+    if (count > 0)                              \
+    {                                           \
+        (pResult) = readv ((pFd), iov, count);  \
+    }                                           \
+    else                                        \
+    {                                           \
+        errno     = ENOBUFS;                    \
+        (pResult) = -1;                         \
+    }                                           \
+    RingBuffer_IoCommit ((pName), (pResult));   \
+}
+
+/**
+ * Sends the used bytes of a ring buffer to a socket w/ a single sendmsg, freeing the bytes sent.
+ *
+ * @warning Not safe against concurrent overwriting pushes (see \ref RingBuffer_Peek).
+ *
+ * @param      pName   Ring buffer to read from.
+ * @param      pFd     Socket.
+ * @param      pFlags  sendmsg flags (e.g. MSG_DONTWAIT | MSG_NOSIGNAL).
+ * @param[out] pResult Bytes sent (ssize_t), 0 if ring buffer is empty, -1 on error (see errno, e.g. EAGAIN).
+ */
+#define RingBuffer_SendMsg(pName, pFd, pFlags, pResult) \
+{                                                       \
+    struct iovec  iov[2];                               \
+    struct msghdr msg;                                  \
+    int           count;                                \
+    (void) memset (&msg, 0x00, sizeof (msg));           \
+    RingBuffer_IoPeek ((pName), iov, count);            \
+    msg.msg_iov    = iov;                               \
+    msg.msg_iovlen = (size_t) count;                    \
+    if (count > 0)                                      \
+    {                                                   \
+        (pResult) = sendmsg ((pFd), &msg, (pFlags));    \
+    }                                                   \
+    else                                                \
+    {                                                   \
+        (pResult) = 0;                                  \
+    }                                                   \
+    RingBuffer_IoRelease ((pName), (pResult));          \
+}
+
+/**
+ * Receives from a socket into the free bytes of a ring buffer w/ a single recvmsg, committing the bytes received.
+ *
+ * @param      pName   Ring buffer to write to.
+ * @param      pFd     Socket.
+ * @param      pFlags  recvmsg flags (e.g. MSG_DONTWAIT).
+ * @param[out] pResult Bytes received (ssize_t), 0 on orderly shutdown, -1 on error (see errno, e.g. EAGAIN, or
+ *                     ENOBUFS if ring buffer is full).
+ */
+#define RingBuffer_RecvMsg(pName, pFd, pFlags, pResult) \
+{                                                       \
+    struct iovec  iov[2];                               \
+    struct msghdr msg;                                  \
+    int           count;                                \
+    (void) memset (&msg, 0x00, sizeof (msg));           \
+    RingBuffer_IoReserve ((pName), iov, count);         \
+    msg.msg_iov    = iov;                               \
+    msg.msg_iovlen = (size_t) count;                    \
+    if (count > 0)                                      \
+    {                                                   \
+        (pResult) = recvmsg ((pFd), &msg, (pFlags));    \
+    }                                                   \
+    else                                                \
+    {                                                   \
+        errno     = ENOBUFS;                            \
+        (pResult) = -1;                                 \
+    }                                                   \
+    RingBuffer_IoCommit ((pName), (pResult));           \
+}
+
+/**
+ * Frees the bytes actually transferred out of a ring buffer, if any.
+ *
+ * @param pName   Ring buffer variable name.
+ * @param pResult Result of the transfer.
+ */
+#define RingBuffer_IoRelease(pName, pResult)                \
+    if ((pResult) > 0)                                      \
+    {                                                       \
+        RingBuffer_Release ((pName), (uint32_t) (pResult)); \
+    }                                                       \
+    else                                                    \
+    {                                                       \
+    }
+
+/**
+ * Publishes the bytes actually transferred into a ring buffer, if any.
+ *
+ * @param pName   Ring buffer variable name.
+ * @param pResult Result of the transfer.
+ */
+#define RingBuffer_IoCommit(pName, pResult)                \
+    if ((pResult) > 0)                                     \
+    {                                                      \
+        RingBuffer_Commit ((pName), (uint32_t) (pResult)); \
+    }                                                      \
+    else                                                   \
+    {                                                      \
+    }
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+#endif /* RING_BUFFER_IO_H__ */
@@ -0,0 +1,375 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Mirror.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only virtual-memory mirrored ring buffer util (Linux only).
+ *
+ * The same memfd pages are mapped twice back to back, hence any run of up to length slots starting at head or tail
+ * is contiguous in memory: bulk copies are a single memcpy and spans can be handed to code expecting linear buffers.
+ * Head and tail are C11 atomics, one producer and one consumer may run concurrently.
+ *
+ * @note Requires _GNU_SOURCE (for memfd_create) to be defined before any system header is included.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_MIRROR_H__
+#define RING_BUFFER_MIRROR_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+/* System includes. */
+#include <sys/mman.h>
+#include <unistd.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/**
+ * Mirrored ring buffer descriptor.
+ */
+typedef struct
+{
+    uint8_t*         ptrBuffer; /**< First of the two adjacent mappings of the same pages. */
+    uint32_t         typeSize;  /**< Size of each element in bytes. */
+    uint32_t         length;    /**< Number of slots (one is kept free to tell full from empty). */
+    uint32_t         size;      /**< Size of each mapping in bytes (multiple of page size). */
+    _Atomic uint32_t head;      /**< Write index in [0, length). */
+    _Atomic uint32_t tail;      /**< Read index in [0, length). */
+} RingBuffer_Mirror_t;
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+/**
+ * Gets the number of slots between two indexes of a mirrored ring buffer.
+ *
+ * @note Mirrored ring buffer length is not a power of two, indexes always wrap regardless of \ref RING_BUFFER_POW2.
+ *
+ * @param[in] ptrRing Ring buffer.
+ * @param     head    Head index.
+ * @param     tail    Tail index.
+ *
+ * @return The number of slots from tail to head.
+ */
+static inline uint32_t
+RingBuffer_MirrorDistance (const RingBuffer_Mirror_t* ptrRing, uint32_t head, uint32_t tail)
+{
+    return (head >= tail) ? (head - tail) : ((ptrRing->length - tail) + head);
+}
+
+/**
+ * Advances an index of a mirrored ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ * @param     index   Index to advance.
+ * @param     size    Number of slots to advance by.
+ *
+ * @return The advanced index.
+ */
+static inline uint32_t
+RingBuffer_MirrorAdvance (const RingBuffer_Mirror_t* ptrRing, uint32_t index, uint32_t size)
+{
+    return ((index + size) >= ptrRing->length) ? ((index + size) - ptrRing->length) : (index + size);
+}
+
+/**
+ * Creates a mirrored ring buffer.
+ *
+ * @note The length is rounded up so that each mapping is a multiple of the page size.
+ *
+ * @param[out] ptrRing  Ring buffer to create.
+ * @param      typeSize Size of each element in bytes.
+ * @param      length   Minimum number of slots.
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise.
+ */
+static inline int32_t
+RingBuffer_MirrorCreate (RingBuffer_Mirror_t* ptrRing, uint32_t typeSize, uint32_t length)
+{
+    int32_t  res;
+    int      fd;
+    size_t   page;
+    size_t   size;
+    uint8_t* ptrBase;
+
+    RingBuffer_Assert ((ptrRing != NULL) && (typeSize > 0UL) && (length > 0UL));
+
+    res     = RING_BUFFER_ERROR;
+    page    = (size_t) sysconf (_SC_PAGESIZE);
+    size    = ((((size_t) typeSize * length) + page - 1U) / page) * page;
+    ptrBase = MAP_FAILED;
+
+    /* Each mapping must hold a whole number of elements. */
+    while ((size % typeSize) != 0U)
+    {
+        size += page;
+    }
+
+    fd = memfd_create ("RingBuffer", MFD_CLOEXEC);
+
+    if ((fd >= 0) && (size <= UINT32_MAX) && (ftruncate (fd, (off_t) size) == 0))
+    {
+        /* Reserve a contiguous address range, then map the same pages twice over it. */
+        ptrBase = mmap (NULL, (2U * size), PROT_NONE, (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+    }
+    else
+    {
+    }
+
+    if (ptrBase != MAP_FAILED)
+    {
+        if ((mmap (ptrBase, size, (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_FIXED), fd, 0) == ptrBase) &&
+            (mmap (&ptrBase[size], size, (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_FIXED), fd, 0) ==
+             &ptrBase[size]))
+        {
+            ptrRing->ptrBuffer = ptrBase;
+            ptrRing->typeSize  = typeSize;
+            ptrRing->length    = (uint32_t) (size / typeSize);
+            ptrRing->size      = (uint32_t) size;
+
+            atomic_init (&ptrRing->head, 0U);
+            atomic_init (&ptrRing->tail, 0U);
+
+            res = RING_BUFFER_OK;
+        }
+        else
+        {
+            (void) munmap (ptrBase, (2U * size));
+        }
+    }
+    else
+    {
+    }
+
+    if (fd >= 0)
+    {
+        /* Mappings keep the memfd alive. */
+        (void) close (fd);
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Destroys a mirrored ring buffer.
+ *
+ * @param[in, out] ptrRing Ring buffer to destroy.
+ */
+static inline void
+RingBuffer_MirrorDestroy (RingBuffer_Mirror_t* ptrRing)
+{
+    RingBuffer_Assert (ptrRing != NULL);
+
+    (void) munmap (ptrRing->ptrBuffer, (2U * (size_t) ptrRing->size));
+
+    ptrRing->ptrBuffer = NULL;
+}
+
+/**
+ * Gets the number of usable slots of a mirrored ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The usable slots number of the ring buffer.
+ */
+static inline uint32_t
+RingBuffer_MirrorGetCapacity (const RingBuffer_Mirror_t* ptrRing)
+{
+    return ptrRing->length - 1UL;
+}
+
+/**
+ * Gets the number of used slots of a mirrored ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The number of slots currently used.
+ */
+static inline uint32_t
+RingBuffer_MirrorGetUsed (RingBuffer_Mirror_t* ptrRing)
+{
+    return RingBuffer_MirrorDistance (ptrRing,
+                                      atomic_load_explicit (&ptrRing->head, memory_order_acquire),
+                                      atomic_load_explicit (&ptrRing->tail, memory_order_acquire));
+}
+
+/**
+ * Gets the number of free slots of a mirrored ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The number of slots currently available.
+ */
+static inline uint32_t
+RingBuffer_MirrorGetFree (RingBuffer_Mirror_t* ptrRing)
+{
+    return RingBuffer_MirrorGetCapacity (ptrRing) - RingBuffer_MirrorGetUsed (ptrRing);
+}
+
+/**
+ * Gets the free slots as a single contiguous span (producer side).
+ *
+ * @param[in]  ptrRing Ring buffer.
+ * @param[out] ptrSize Number of contiguous free slots.
+ *
+ * @return Pointer to the first free slot.
+ */
+static inline void*
+RingBuffer_MirrorReserve (RingBuffer_Mirror_t* ptrRing, uint32_t* ptrSize)
+{
+    uint32_t head;
+
+    head = atomic_load_explicit (&ptrRing->head, memory_order_relaxed);
+
+    *ptrSize = RingBuffer_MirrorGetCapacity (ptrRing) -
+               RingBuffer_MirrorDistance (ptrRing, head, atomic_load_explicit (&ptrRing->tail, memory_order_acquire));
+
+    return &ptrRing->ptrBuffer[(size_t) head * ptrRing->typeSize];
+}
+
+/**
+ * Commits slots written in place after \ref RingBuffer_MirrorReserve (producer side).
+ *
+ * @param[in, out] ptrRing Ring buffer.
+ * @param          size    Number of slots to commit.
+ */
+static inline void
+RingBuffer_MirrorCommit (RingBuffer_Mirror_t* ptrRing, uint32_t size)
+{
+    uint32_t head;
+
+    RingBuffer_Assert (size <= RingBuffer_MirrorGetFree (ptrRing));
+
+    head = atomic_load_explicit (&ptrRing->head, memory_order_relaxed);
+
+    atomic_store_explicit (&ptrRing->head, RingBuffer_MirrorAdvance (ptrRing, head, size), memory_order_release);
+}
+
+/**
+ * Gets the used slots as a single contiguous span (consumer side).
+ *
+ * @param[in]  ptrRing Ring buffer.
+ * @param[out] ptrSize Number of contiguous used slots.
+ *
+ * @return Pointer to the first used slot.
+ */
+static inline void*
+RingBuffer_MirrorPeek (RingBuffer_Mirror_t* ptrRing, uint32_t* ptrSize)
+{
+    uint32_t tail;
+
+    tail = atomic_load_explicit (&ptrRing->tail, memory_order_relaxed);
+
+    *ptrSize = RingBuffer_MirrorDistance (ptrRing, atomic_load_explicit (&ptrRing->head, memory_order_acquire), tail);
+
+    return &ptrRing->ptrBuffer[(size_t) tail * ptrRing->typeSize];
+}
+
+/**
+ * Releases slots read in place after \ref RingBuffer_MirrorPeek (consumer side).
+ *
+ * @param[in, out] ptrRing Ring buffer.
+ * @param          size    Number of slots to release.
+ */
+static inline void
+RingBuffer_MirrorRelease (RingBuffer_Mirror_t* ptrRing, uint32_t size)
+{
+    uint32_t tail;
+
+    RingBuffer_Assert (size <= RingBuffer_MirrorGetUsed (ptrRing));
+
+    tail = atomic_load_explicit (&ptrRing->tail, memory_order_relaxed);
+
+    atomic_store_explicit (&ptrRing->tail, RingBuffer_MirrorAdvance (ptrRing, tail, size), memory_order_release);
+}
+
+/**
+ * Pushes up to size items into a mirrored ring buffer w/ a single memcpy.
+ *
+ * @param[in, out] ptrRing    Ring buffer to push to.
+ * @param[in]      ptrSource  Linear buffer to copy data from.
+ * @param          size       Number of items to push.
+ *
+ * @return The number of items actually pushed.
+ */
+static inline uint32_t
+RingBuffer_MirrorPushBulk (RingBuffer_Mirror_t* ptrRing, const void* ptrSource, uint32_t size)
+{
+    uint32_t available;
+    void*    ptrDest;
+
+    ptrDest = RingBuffer_MirrorReserve (ptrRing, &available);
+
+    if (size < available)
+    {
+        available = size;
+    }
+    else
+    {
+    }
+
+    (void) memcpy (ptrDest, ptrSource, ((size_t) available * ptrRing->typeSize));
+
+    RingBuffer_MirrorCommit (ptrRing, available);
+
+    return available;
+}
+
+/**
+ * Pops up to size items from a mirrored ring buffer w/ a single memcpy.
+ *
+ * @param[in, out] ptrRing Ring buffer to pop from.
+ * @param[out]     ptrDest Linear buffer to copy data to.
+ * @param          size    Number of items to pop.
+ *
+ * @return The number of items actually popped.
+ */
+static inline uint32_t
+RingBuffer_MirrorPopBulk (RingBuffer_Mirror_t* ptrRing, void* ptrDest, uint32_t size)
+{
+    uint32_t used;
+    void*    ptrSource;
+
+    ptrSource = RingBuffer_MirrorPeek (ptrRing, &used);
+
+    if (size < used)
+    {
+        used = size;
+    }
+    else
+    {
+    }
+
+    (void) memcpy (ptrDest, ptrSource, ((size_t) used * ptrRing->typeSize));
+
+    RingBuffer_MirrorRelease (ptrRing, used);
+
+    return used;
+}
+
+#endif /* RING_BUFFER_MIRROR_H__ */
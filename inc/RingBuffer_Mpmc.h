@@ -0,0 +1,211 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Mpmc.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only lock-free multi-producer/multi-consumer ring buffer util.
+ *
+ * Each slot carries a sequence counter telling whether it is ready to be written (sequence == position) or to be
+ * read (sequence == position + 1). Producers only compete on head and consumers only compete on tail, both claimed
+ * by CAS, so no global lock is needed.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_MPMC_H__
+#define RING_BUFFER_MPMC_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stdatomic.h>
+#include <stdint.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/**
+ * Macro for creating a MPMC ring buffer.
+ *
+ * @note \ref RingBuffer_MpmcInit must be called before using the ring buffer.
+ *
+ * @param pStorageClass Storage class for the ring buffer (e.g. static).
+ * @param pType         Type of ring buffer elements (e.g. uint8_t).
+ * @param pName         Ring buffer name.
+ * @param pLength       Ring buffer length (must be a power of two, checked at compile time).
+ *
+ * @note Head and tail always lie on separate cache lines (regardless of \ref RING_BUFFER_CACHE_ALIGN): producers and
+ *       consumers only contend on the index they claim.
+ */
+// cppcheck-suppress misra-c2012-20.7; no way to enclose pStorageClass / pName due to X-macro
+#define RingBuffer_MpmcCreate(pStorageClass, pType, pName, pLength)              \
+    pStorageClass struct                                                         \
+    {                                                                            \
+        struct                                                                   \
+        {                                                                        \
+            _Atomic uint32_t sequence;                                           \
+            pType            item;                                               \
+        } slots[(pLength)];                                                      \
+        _Static_assert (((pLength) > 0) && (((pLength) & ((pLength) - 1)) == 0), \
+                        "MPMC ring buffer requires a power of two length");      \
+        _Alignas (RING_BUFFER_CACHE_LINE_SIZE) _Atomic uint32_t head;            \
+        _Alignas (RING_BUFFER_CACHE_LINE_SIZE) _Atomic uint32_t tail;            \
+    } pName
+
+/**
+ * Gets the total slots number of the MPMC ring buffer.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The slots number of the ring buffer.
+ */
+#define RingBuffer_MpmcGetLength(pName) \
+    (sizeof ((pName).slots) / sizeof ((pName).slots[0]))
+
+/**
+ * Gets the number of the used slots in the MPMC ring buffer.
+ *
+ * @note The value is a snapshot: concurrent producers / consumers may change it at any time.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The number of slots currently used.
+ */
+#define RingBuffer_MpmcGetUsed(pName)                                         \
+    ((uint32_t) (atomic_load_explicit (&(pName).head, memory_order_relaxed) - \
+                 atomic_load_explicit (&(pName).tail, memory_order_relaxed)))
+
+/**
+ * Initializes the slot sequences and the indexes of a MPMC ring buffer.
+ *
+ * @warning Neither producers nor consumers must be running.
+ *
+ * @param pName Ring buffer variable name.
+ */
+#define RingBuffer_MpmcInit(pName)                                                   \
+{                                                                                    \
+    uint32_t i;                                                                      \
+    for (i = 0U; i < RingBuffer_MpmcGetLength ((pName)); i++)                        \
+    {                                                                                \
+        atomic_store_explicit (&(pName).slots[i].sequence, i, memory_order_relaxed); \
+    }                                                                                \
+    atomic_store_explicit (&(pName).head, 0U, memory_order_relaxed);                 \
+    atomic_store_explicit (&(pName).tail, 0U, memory_order_release);                 \
+}
+
+/**
+ * Tries to push single item into MPMC ring buffer.
+ *
+ * @param      pName   Ring buffer to push to.
+ * @param      pItem   Item to push.
+ * @param[out] pStatus \ref RING_BUFFER_OK if pushed, \ref RING_BUFFER_FULL if ring buffer is full.
+ */
+#define RingBuffer_MpmcTryPush(pName, pItem, pStatus)                                                    \
+{                                                                                                        \
+    uint32_t position;                                                                                   \
+    uint32_t index;                                                                                      \
+    int32_t  diff;                                                                                       \
+    (pStatus) = RING_BUFFER_BUSY;                                                                        \
+    position  = atomic_load_explicit (&(pName).head, memory_order_relaxed);                              \
+    while ((pStatus) == RING_BUFFER_BUSY)                                                                \
+    {                                                                                                    \
+        index = position & (uint32_t) (RingBuffer_MpmcGetLength ((pName)) - 1UL);                        \
+        diff  = (int32_t) (atomic_load_explicit (&(pName).slots[index].sequence, memory_order_acquire) - \
+                           position);                                                                    \
+        if (diff == 0)                                                                                   \
+        {                                                                                                \
+            if (atomic_compare_exchange_weak_explicit (&(pName).head, &position, position + 1U,          \
+                                                       memory_order_relaxed, memory_order_relaxed))      \
+            {                                                                                            \
+                (pStatus) = RING_BUFFER_OK;                                                              \
+            }                                                                                            \
+            else                                                                                         \
+            {                                                                                            \
+            }                                                                                            \
+        }                                                                                                \
+        else if (diff < 0)                                                                               \
+        {                                                                                                \
+            (pStatus) = RING_BUFFER_FULL;                                                                \
+        }                                                                                                \
+        else                                                                                             \
+        {                                                                                                \
+            position = atomic_load_explicit (&(pName).head, memory_order_relaxed);                       \
+        }                                                                                                \
+    }                                                                                                    \
+    if ((pStatus) == RING_BUFFER_OK)                                                                     \
+    {                                                                                                    \
+        (pName).slots[index].item = (pItem);                                                             \
+        atomic_store_explicit (&(pName).slots[index].sequence, position + 1U, memory_order_release);     \
+    }                                                                                                    \
+    else                                                                                                 \
+    {                                                                                                    \
+    }                                                                                                    \
+}
+
+/**
+ * Tries to pop single item from MPMC ring buffer.
+ *
+ * @param      pName   Ring buffer to pop from.
+ * @param      pItem   Item to copy to the popped item.
+ * @param[out] pStatus \ref RING_BUFFER_OK if popped, \ref RING_BUFFER_EMPTY if ring buffer is empty.
+ */
+#define RingBuffer_MpmcTryPop(pName, pItem, pStatus)                                                     \
+{                                                                                                        \
+    uint32_t position;                                                                                   \
+    uint32_t index;                                                                                      \
+    int32_t  diff;                                                                                       \
+    (pStatus) = RING_BUFFER_BUSY;                                                                        \
+    position  = atomic_load_explicit (&(pName).tail, memory_order_relaxed);                              \
+    while ((pStatus) == RING_BUFFER_BUSY)                                                                \
+    {                                                                                                    \
+        index = position & (uint32_t) (RingBuffer_MpmcGetLength ((pName)) - 1UL);                        \
+        diff  = (int32_t) (atomic_load_explicit (&(pName).slots[index].sequence, memory_order_acquire) - \
+                           (position + 1U));                                                             \
+        if (diff == 0)                                                                                   \
+        {                                                                                                \
+            if (atomic_compare_exchange_weak_explicit (&(pName).tail, &position, position + 1U,          \
+                                                       memory_order_relaxed, memory_order_relaxed))      \
+            {                                                                                            \
+                (pStatus) = RING_BUFFER_OK;                                                              \
+            }                                                                                            \
+            else                                                                                         \
+            {                                                                                            \
+            }                                                                                            \
+        }                                                                                                \
+        else if (diff < 0)                                                                               \
+        {                                                                                                \
+            (pStatus) = RING_BUFFER_EMPTY;                                                               \
+        }                                                                                                \
+        else                                                                                             \
+        {                                                                                                \
+            position = atomic_load_explicit (&(pName).tail, memory_order_relaxed);                       \
+        }                                                                                                \
+    }                                                                                                    \
+    if ((pStatus) == RING_BUFFER_OK)                                                                     \
+    {                                                                                                    \
+        (pItem) = (pName).slots[index].item;                                                             \
+        atomic_store_explicit (&(pName).slots[index].sequence,                                           \
+                               position + (uint32_t) RingBuffer_MpmcGetLength ((pName)),                 \
+                               memory_order_release);                                                    \
+    }                                                                                                    \
+    else                                                                                                 \
+    {                                                                                                    \
+    }                                                                                                    \
+}
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+#endif /* RING_BUFFER_MPMC_H__ */
@@ -0,0 +1,253 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Record.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only variable-length record util on top of a uint8_t ring buffer.
+ *
+ * Each record is a 4-byte header holding the payload size, followed by the payload, padded to
+ * \ref RING_BUFFER_RECORD_ALIGN bytes. A record never straddles the wrap: if it does not fit before the end of the
+ * array, a skip marker is written instead and the record starts over at the beginning. Records are written / read in
+ * place through \ref RingBuffer_Reserve / \ref RingBuffer_Commit and \ref RingBuffer_Peek / \ref RingBuffer_Release,
+ * hence the same thread-safety rules apply (one producer and one consumer at a time).
+ *
+ * @note Ring buffer must be created w/ uint8_t type and a length multiple of \ref RING_BUFFER_RECORD_ALIGN.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_RECORD_H__
+#define RING_BUFFER_RECORD_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+#ifndef RING_BUFFER_RECORD_ALIGN
+    #define RING_BUFFER_RECORD_ALIGN 4
+#endif /* RING_BUFFER_RECORD_ALIGN */
+
+/**
+ * Size of the record header in bytes.
+ */
+#define RING_BUFFER_RECORD_HEADER_SIZE 4U
+
+#if (RING_BUFFER_RECORD_ALIGN < 4) || ((RING_BUFFER_RECORD_ALIGN & (RING_BUFFER_RECORD_ALIGN - 1)) != 0)
+    #error "RING_BUFFER_RECORD_ALIGN must be a power of two not less than the record header size"
+#endif /* (RING_BUFFER_RECORD_ALIGN < 4) || ((RING_BUFFER_RECORD_ALIGN & (RING_BUFFER_RECORD_ALIGN - 1)) != 0) */
+
+/**
+ * Record header flag marking the padding up to the end of the array.
+ */
+#define RING_BUFFER_RECORD_SKIP 0x80000000UL
+
+/**
+ * Checks that a ring buffer can hold records.
+ *
+ * @param pName Ring buffer variable name.
+ */
+#define RingBuffer_RecordCheck(pName)                              \
+    RingBuffer_Assert ((RingBuffer_GetTypeSize ((pName)) == 1U) && \
+                       ((RingBuffer_GetLength ((pName)) % RING_BUFFER_RECORD_ALIGN) == 0U))
+
+/**
+ * Gets the number of bytes padding a record up to the end of the array.
+ *
+ * @param     pName      Ring buffer variable name.
+ * @param[in] pPtrHeader Record header.
+ * @param     pIndex     Head (producer) or tail (consumer) index.
+ *
+ * @return 0 if the record starts at the index, the bytes from the index up to the end of the array otherwise.
+ */
+#define RingBuffer_RecordGetPadding(pName, pPtrHeader, pIndex)                  \
+    (((pPtrHeader) == &(pName).array[RingBuffer_GetSlot ((pName), (pIndex))]) ? \
+     0UL : (uint32_t) (RingBuffer_GetLength ((pName)) - RingBuffer_GetSlot ((pName), (pIndex))))
+
+/**
+ * Reserves a contiguous record of pSize bytes to be written in place.
+ *
+ * @note The record is not visible to the consumer until \ref RingBuffer_RecordCommit is called; only one
+ *       reservation at a time is allowed. Full ring buffer is never overwritten.
+ *
+ * @param      pName      Ring buffer to write to.
+ * @param      pSize      Payload size in bytes.
+ * @param[out] pPtrRecord Pointer to the payload (uint8_t*), NULL if the record does not fit.
+ */
+#define RingBuffer_RecordReserve(pName, pSize, pPtrRecord)                                                      \
+{                                                                                                               \
+    uint8_t* ptrFirst;                                                                                          \
+    uint8_t* ptrSecond;                                                                                         \
+    uint32_t firstSize;                                                                                         \
+    uint32_t secondSize;                                                                                        \
+    uint32_t recordSize;                                                                                        \
+    RingBuffer_RecordCheck ((pName));                                                                           \
+    recordSize = RingBuffer_RecordGetSize ((pSize));                                                            \
+    RingBuffer_Reserve ((pName), RingBuffer_GetCapacity ((pName)), ptrFirst, firstSize, ptrSecond, secondSize); \
+    if ((pSize) >= RingBuffer_GetCapacity ((pName)))                                                            \
+    {                                                                                                           \
+        (pPtrRecord) = NULL;                                                                                    \
+    }                                                                                                           \
+    else if (firstSize >= recordSize)                                                                           \
+    {                                                                                                           \
+        (pPtrRecord) = &ptrFirst[RING_BUFFER_RECORD_HEADER_SIZE];                                               \
+    }                                                                                                           \
+    else if (secondSize >= recordSize)                                                                          \
+    {                                                                                                           \
+        (pPtrRecord) = &ptrSecond[RING_BUFFER_RECORD_HEADER_SIZE];                                              \
+    }                                                                                                           \
+    else                                                                                                        \
+    {                                                                                                           \
+        (pPtrRecord) = NULL;                                                                                    \
+    }                                                                                                           \
+}
+
+/**
+ * Commits a record previously reserved and written in place, making it visible to the consumer.
+ *
+ * @param     pName      Ring buffer to commit to.
+ * @param[in] pPtrRecord Pointer to the payload, as returned by \ref RingBuffer_RecordReserve.
+ * @param     pSize      Payload size in bytes (at most the reserved one).
+ */
+#define RingBuffer_RecordCommit(pName, pPtrRecord, pSize)                                                             \
+{                                                                                                                     \
+    uint8_t* ptrHeader;                                                                                               \
+    uint32_t padding;                                                                                                 \
+    ptrHeader = &(pPtrRecord)[-((ptrdiff_t) RING_BUFFER_RECORD_HEADER_SIZE)];                                         \
+    padding   = RingBuffer_RecordGetPadding ((pName), ptrHeader, RingBuffer_GetIndex ((pName).head));                 \
+    if (padding != 0UL)                                                                                               \
+    {                                                                                                                 \
+        RingBuffer_RecordSetHeader (&(pName).array[RingBuffer_GetSlot ((pName), RingBuffer_GetIndex ((pName).head))], \
+                                    (RING_BUFFER_RECORD_SKIP | padding));                                             \
+    }                                                                                                                 \
+    else                                                                                                              \
+    {                                                                                                                 \
+    }                                                                                                                 \
+    RingBuffer_RecordSetHeader (ptrHeader, (pSize));                                                                  \
+    RingBuffer_Commit ((pName), (padding + RingBuffer_RecordGetSize ((pSize))));                                      \
+}
+
+/**
+ * Peeks the oldest record to be read in place, skipping the padding up to the end of the array.
+ *
+ * @note The record is not freed until \ref RingBuffer_RecordConsume is called; only one peek at a time is allowed.
+ *
+ * @param      pName      Ring buffer to read from.
+ * @param[out] pPtrRecord Pointer to the payload (uint8_t*), NULL if ring buffer is empty.
+ * @param[out] pSize      Payload size in bytes (0 if ring buffer is empty).
+ */
+#define RingBuffer_RecordPeek(pName, pPtrRecord, pSize)                                                      \
+{                                                                                                            \
+    uint8_t* ptrFirst;                                                                                       \
+    uint8_t* ptrSecond;                                                                                      \
+    uint32_t firstSize;                                                                                      \
+    uint32_t secondSize;                                                                                     \
+    uint32_t header;                                                                                         \
+    RingBuffer_RecordCheck ((pName));                                                                        \
+    RingBuffer_Peek ((pName), RingBuffer_GetCapacity ((pName)), ptrFirst, firstSize, ptrSecond, secondSize); \
+    if (firstSize != 0UL)                                                                                    \
+    {                                                                                                        \
+        header = RingBuffer_RecordGetHeader (ptrFirst);                                                      \
+        if ((header & RING_BUFFER_RECORD_SKIP) != 0UL)                                                       \
+        {                                                                                                    \
+            RingBuffer_Assert (secondSize >= RING_BUFFER_RECORD_HEADER_SIZE);                                \
+            ptrFirst = ptrSecond;                                                                            \
+            header   = RingBuffer_RecordGetHeader (ptrFirst);                                                \
+        }                                                                                                    \
+        else                                                                                                 \
+        {                                                                                                    \
+        }                                                                                                    \
+        (pPtrRecord) = &ptrFirst[RING_BUFFER_RECORD_HEADER_SIZE];                                            \
+        (pSize)      = header;                                                                               \
+    }                                                                                                        \
+    else                                                                                                     \
+    {                                                                                                        \
+        (pPtrRecord) = NULL;                                                                                 \
+        (pSize)      = 0UL;                                                                                  \
+    }                                                                                                        \
+}
+
+/**
+ * Consumes a record previously peeked, making its bytes (and the padding before it, if any) available to the
+ * producer.
+ *
+ * @param     pName      Ring buffer to release to.
+ * @param[in] pPtrRecord Pointer to the payload, as returned by \ref RingBuffer_RecordPeek.
+ */
+#define RingBuffer_RecordConsume(pName, pPtrRecord)                                                              \
+{                                                                                                                \
+    const uint8_t* ptrHeader;                                                                                    \
+    uint32_t       padding;                                                                                      \
+    ptrHeader = &(pPtrRecord)[-((ptrdiff_t) RING_BUFFER_RECORD_HEADER_SIZE)];                                    \
+    padding   = RingBuffer_RecordGetPadding ((pName), ptrHeader, RingBuffer_GetIndex ((pName).tail));            \
+    RingBuffer_Release ((pName), (padding + RingBuffer_RecordGetSize (RingBuffer_RecordGetHeader (ptrHeader)))); \
+}
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+/**
+ * Gets the number of bytes a record takes in the ring buffer (header, payload and alignment padding).
+ *
+ * @param size Payload size in bytes.
+ *
+ * @return The record size in bytes.
+ */
+static inline uint32_t
+RingBuffer_RecordGetSize (uint32_t size)
+{
+    return (size + RING_BUFFER_RECORD_HEADER_SIZE + ((uint32_t) RING_BUFFER_RECORD_ALIGN - 1U)) &
+           ~((uint32_t) RING_BUFFER_RECORD_ALIGN - 1U);
+}
+
+/**
+ * Reads a record header (the array is not accessed through a uint32_t pointer, so strict aliasing holds).
+ *
+ * @param[in] ptrHeader Record header.
+ *
+ * @return The payload size, or'ed w/ \ref RING_BUFFER_RECORD_SKIP for padding.
+ */
+static inline uint32_t
+RingBuffer_RecordGetHeader (const uint8_t* ptrHeader)
+{
+    uint32_t header;
+
+    (void) memcpy (&header, ptrHeader, sizeof (header));
+
+    return header;
+}
+
+/**
+ * Writes a record header.
+ *
+ * @param[out] ptrHeader Record header.
+ * @param      header    Payload size, or'ed w/ \ref RING_BUFFER_RECORD_SKIP for padding.
+ */
+static inline void
+RingBuffer_RecordSetHeader (uint8_t* ptrHeader, uint32_t header)
+{
+    (void) memcpy (ptrHeader, &header, sizeof (header));
+}
+
+#endif /* RING_BUFFER_RECORD_H__ */
@@ -0,0 +1,300 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Shard.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only sharded ring buffer util: one ring buffer per producer thread, drained by a single collector.
+ *
+ * Each producer thread attaches to its own shard, a plain ring buffer (see \ref RingBuffer_Type) pushed to through
+ * the usual macros, so producers never contend on the same indexes. The collector drains all shards in batches
+ * through the bulk pop path, or merges them in order of a key field of the items (e.g. a sequence number or a
+ * timestamp).
+ *
+ * @note Enable \ref RING_BUFFER_SPSC so that shards are lock-free, and \ref RING_BUFFER_CACHE_ALIGN so that
+ *       adjacent shards do not share cache lines.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_SHARD_H__
+#define RING_BUFFER_SHARD_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stdatomic.h>
+#include <stdint.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/**
+ * Macro for creating a sharded ring buffer.
+ *
+ * @note \ref RingBuffer_ShardInit must be called before using the ring buffer.
+ *
+ * @param pStorageClass Storage class for the ring buffer (e.g. static).
+ * @param pType         Type of ring buffer elements (e.g. uint8_t).
+ * @param pName         Ring buffer name.
+ * @param pLength       Length of each shard (must be a power of two if \ref RING_BUFFER_POW2 is enabled).
+ * @param pShards       Number of shards.
+ */
+// cppcheck-suppress misra-c2012-20.7; no way to enclose pStorageClass / pName due to X-macro
+#define RingBuffer_ShardCreate(pStorageClass, pType, pName, pLength, pShards) \
+    pStorageClass struct                                                      \
+    {                                                                         \
+        RingBuffer_Type (pType, (pLength)) shards[(pShards)];                 \
+        _Atomic uint32_t owners[(pShards)];                                   \
+        _Atomic uint32_t hint;                                                \
+        uint32_t         next;                                                \
+    } pName
+
+/**
+ * Gets the number of shards.
+ *
+ * @param pName Ring buffer variable name.
+ *
+ * @return The number of shards.
+ */
+#define RingBuffer_ShardGetCount(pName) \
+    (sizeof ((pName).shards) / sizeof ((pName).shards[0]))
+
+/**
+ * Gets a shard, to be used w/ the ring buffer macros (e.g. RingBuffer_Push (RingBuffer_ShardGet (log, shard), item)).
+ *
+ * @param pName  Ring buffer variable name.
+ * @param pShard Shard index.
+ *
+ * @return The shard ring buffer.
+ */
+#define RingBuffer_ShardGet(pName, pShard) \
+    (pName).shards[(pShard)]
+
+/**
+ * Initializes a sharded ring buffer.
+ *
+ * @warning Neither the producers nor the collector must be running.
+ *
+ * @param          pName        Ring buffer variable name.
+ * @param          pPolicy      Full ring buffer policy of the shards (\ref RING_BUFFER_REJECT, \ref RING_BUFFER_DROP
+ *                              or \ref RING_BUFFER_BLOCK; \ref RING_BUFFER_OVERWRITE only if \ref RING_BUFFER_SPSC
+ *                              is enabled, since the collector reads the shards in place).
+ * @param[in]      pPtrCallback Protect callback (\ref RING_BUFFER_PROTECT must be eanbled).
+ * @param[in, out] pPtrArgs     Array of protect callback arguments, one per shard (if \ref RING_BUFFER_PROTECT is
+ *                              enabled).
+ */
+#if (RING_BUFFER_PROTECT == 1)
+    #define RingBuffer_ShardInit(pName, pPolicy, pPtrCallback, pPtrArgs)                        \
+        {                                                                                       \
+            uint32_t i;                                                                         \
+            for (i = 0U; i < RingBuffer_ShardGetCount ((pName)); i++)                           \
+            {                                                                                   \
+                RingBuffer_Init ((pName).shards[i], (pPolicy), (pPtrCallback), &(pPtrArgs)[i]); \
+                atomic_store_explicit (&(pName).owners[i], 0U, memory_order_relaxed);           \
+            }                                                                                   \
+            (pName).next = 0U;                                                                  \
+            atomic_store_explicit (&(pName).hint, 0U, memory_order_release);                    \
+        }
+#else
+    #define RingBuffer_ShardInit(pName, pPolicy, ...)                                 \
+        {                                                                             \
+            uint32_t i;                                                               \
+            for (i = 0U; i < RingBuffer_ShardGetCount ((pName)); i++)                 \
+            {                                                                         \
+                RingBuffer_Init ((pName).shards[i], (pPolicy));                       \
+                atomic_store_explicit (&(pName).owners[i], 0U, memory_order_relaxed); \
+            }                                                                         \
+            (pName).next = 0U;                                                        \
+            atomic_store_explicit (&(pName).hint, 0U, memory_order_release);          \
+        }
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+/**
+ * Attaches the calling producer thread to a free shard.
+ *
+ * @note If \ref RING_BUFFER_PROTECT is enabled and all shards are taken, producers share them (their pushes are
+ *       serialized by the shard lock): pShard is never -1.
+ *
+ * @param      pName  Ring buffer variable name.
+ * @param[out] pShard Shard index (int32_t), -1 if all shards are taken.
+ */
+#define RingBuffer_ShardAttach(pName, pShard)                                                     \
+{                                                                                                 \
+    uint32_t i;                                                                                   \
+    uint32_t first;                                                                               \
+    uint32_t candidate;                                                                           \
+    uint32_t expected;                                                                            \
+    (pShard)  = -1;                                                                               \
+    first     = atomic_fetch_add_explicit (&(pName).hint, 1U, memory_order_relaxed);              \
+    for (i = 0U; (i < RingBuffer_ShardGetCount ((pName))) && ((pShard) < 0); i++)                 \
+    {                                                                                             \
+        candidate = (uint32_t) ((first + i) % RingBuffer_ShardGetCount ((pName)));                \
+        expected  = 0U;                                                                           \
+        if (atomic_compare_exchange_strong_explicit (&(pName).owners[candidate], &expected, 1U,   \
+                                                     memory_order_acquire, memory_order_relaxed)) \
+        {                                                                                         \
+            (pShard) = (int32_t) candidate;                                                       \
+        }                                                                                         \
+        else                                                                                      \
+        {                                                                                         \
+        }                                                                                         \
+    }                                                                                             \
+    RingBuffer_ShardShare ((pName), first, (pShard));                                             \
+}
+
+/**
+ * Shares a taken shard if none is free (if \ref RING_BUFFER_PROTECT is enabled).
+ *
+ * @param      pName  Ring buffer variable name.
+ * @param      pFirst Attach hint.
+ * @param[out] pShard Shard index.
+ */
+#if (RING_BUFFER_PROTECT == 1)
+    #define RingBuffer_ShardShare(pName, pFirst, pShard)                          \
+        if ((pShard) < 0)                                                         \
+        {                                                                         \
+            (pShard) = (int32_t) ((pFirst) % RingBuffer_ShardGetCount ((pName))); \
+        }                                                                         \
+        else                                                                      \
+        {                                                                         \
+        }
+#else
+    #define RingBuffer_ShardShare(pName, pFirst, pShard)
+#endif /* RING_BUFFER_PROTECT == 1 */
+
+/**
+ * Detaches the calling producer thread from its shard: items still in the shard are collected anyway.
+ *
+ * @param pName  Ring buffer variable name.
+ * @param pShard Shard index.
+ */
+#define RingBuffer_ShardDetach(pName, pShard) \
+    atomic_store_explicit (&(pName).owners[(pShard)], 0U, memory_order_release)
+
+/**
+ * Drains up to pSize items from all shards, one bulk pop per shard (single collector).
+ *
+ * @note Shards are visited round-robin, starting from a different one at each call, so that a busy shard cannot
+ *       starve the others when pSize is smaller than the items available. Items of the same shard keep their order.
+ *
+ * @param      pName    Ring buffer to drain.
+ * @param[out] pPtrDest Linear buffer to copy data to.
+ * @param      pSize    Maximum number of items to drain.
+ * @param[out] pCount   Number of items actually drained.
+ */
+#define RingBuffer_ShardDrain(pName, pPtrDest, pSize, pCount)                                          \
+{                                                                                                      \
+    uint32_t i;                                                                                        \
+    uint32_t shard;                                                                                    \
+    uint32_t popped;                                                                                   \
+    (pCount) = 0U;                                                                                     \
+    for (i = 0U; (i < RingBuffer_ShardGetCount ((pName))) && ((pCount) < (pSize)); i++)                \
+    {                                                                                                  \
+        shard = (uint32_t) (((pName).next + i) % RingBuffer_ShardGetCount ((pName)));                  \
+        RingBuffer_PopBulk ((pName).shards[shard], &(pPtrDest)[(pCount)], (pSize) - (pCount), popped); \
+        (pCount) += popped;                                                                            \
+    }                                                                                                  \
+    (pName).next = (uint32_t) (((pName).next + 1U) % RingBuffer_ShardGetCount ((pName)));              \
+}
+
+/**
+ * Drains up to pSize items from all shards, merged in ascending order of an item field (single collector).
+ *
+ * @note Each shard is peeked and released once per call: the items pushed meanwhile are left for the next call.
+ * @note The output is ordered as long as each producer pushes ascending keys (e.g. a per-thread sequence or a
+ *       monotonic timestamp); ties are broken in favour of the lowest shard index.
+ *
+ * @param      pName    Ring buffer to drain.
+ * @param      pField   Name of the item field to order by (e.g. timestamp), compared w/ <.
+ * @param[out] pPtrDest Linear buffer to copy data to.
+ * @param      pSize    Maximum number of items to drain.
+ * @param[out] pCount   Number of items actually drained.
+ */
+#define RingBuffer_ShardMerge(pName, pField, pPtrDest, pSize, pCount)                                          \
+{                                                                                                              \
+    uint32_t i;                                                                                                \
+    uint32_t best;                                                                                             \
+    uint32_t firstSize;                                                                                        \
+    uint32_t secondSize;                                                                                       \
+    void*    ptrFirst;                                                                                         \
+    void*    ptrSecond;                                                                                        \
+    uint32_t slots[RingBuffer_ShardGetCount ((pName))];                                                        \
+    uint32_t avail[RingBuffer_ShardGetCount ((pName))];                                                        \
+    uint32_t taken[RingBuffer_ShardGetCount ((pName))];                                                        \
+    for (i = 0U; i < RingBuffer_ShardGetCount ((pName)); i++)                                                  \
+    {                                                                                                          \
+        RingBuffer_Peek ((pName).shards[i], RingBuffer_GetCapacity ((pName).shards[i]),                        \
+                         ptrFirst, firstSize, ptrSecond, secondSize);                                          \
+        slots[i] = (uint32_t) (((uint8_t*) ptrFirst - (uint8_t*) &(pName).shards[i].array[0])                  \
+                               / RingBuffer_GetTypeSize ((pName).shards[i]));                                  \
+        avail[i] = firstSize + secondSize;                                                                     \
+        taken[i] = 0U;                                                                                         \
+    }                                                                                                          \
+    (void) ptrSecond;                                                                                          \
+    (pCount) = 0U;                                                                                             \
+    best     = 0U;                                                                                             \
+    while (((pCount) < (pSize)) && (best < RingBuffer_ShardGetCount ((pName))))                                \
+    {                                                                                                          \
+        best = (uint32_t) RingBuffer_ShardGetCount ((pName));                                                  \
+        for (i = 0U; i < RingBuffer_ShardGetCount ((pName)); i++)                                              \
+        {                                                                                                      \
+            if ((taken[i] < avail[i]) &&                                                                       \
+                ((best == RingBuffer_ShardGetCount ((pName))) ||                                               \
+                 ((pName).shards[i].array[slots[i]].pField < (pName).shards[best].array[slots[best]].pField))) \
+            {                                                                                                  \
+                best = i;                                                                                      \
+            }                                                                                                  \
+            else                                                                                               \
+            {                                                                                                  \
+            }                                                                                                  \
+        }                                                                                                      \
+        if (best < RingBuffer_ShardGetCount ((pName)))                                                         \
+        {                                                                                                      \
+            (pPtrDest)[(pCount)] = (pName).shards[best].array[slots[best]];                                    \
+            (pCount)++;                                                                                        \
+            taken[best]++;                                                                                     \
+            slots[best]++;                                                                                     \
+            if (slots[best] == RingBuffer_GetLength ((pName).shards[best]))                                    \
+            {                                                                                                  \
+                slots[best] = 0U;                                                                              \
+            }                                                                                                  \
+            else                                                                                               \
+            {                                                                                                  \
+            }                                                                                                  \
+        }                                                                                                      \
+        else                                                                                                   \
+        {                                                                                                      \
+        }                                                                                                      \
+    }                                                                                                          \
+    for (i = 0U; i < RingBuffer_ShardGetCount ((pName)); i++)                                                  \
+    {                                                                                                          \
+        if (taken[i] > 0U)                                                                                     \
+        {                                                                                                      \
+            RingBuffer_Release ((pName).shards[i], taken[i]);                                                  \
+        }                                                                                                      \
+        else                                                                                                   \
+        {                                                                                                      \
+        }                                                                                                      \
+    }                                                                                                          \
+}
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+#endif /* RING_BUFFER_SHARD_H__ */
@@ -0,0 +1,542 @@
+/**
+ * Copyright 2021 <Alessandro Morniroli>
+ *
+ * @file   RingBuffer_Shm.h
+ * @author Alessandro Morniroli <alessandro.morniroli@gmail.com>
+ * @date   Mon Mar 15 2021
+ *
+ * @brief  Header-only cross-process ring buffer util in POSIX shared memory or memfd (Linux only).
+ *
+ * The segment starts w/ a header (magic, version, element size, length and the head / tail indexes on their own cache
+ * lines) followed by the slots: it holds no pointer, so each process may map it at a different address. Head and tail
+ * are lock-free C11 atomics, one producer process and one consumer process may run concurrently. Each process keeps
+ * its own copy of the opposite index and of the validated geometry in a local \ref RingBuffer_Shm_t.
+ *
+ * @note The layout does not depend on the ring buffer configuration, so processes built w/ different options can
+ *       share a segment. Requires _GNU_SOURCE (for memfd_create) to be defined before any system header is included.
+ */
+
+/* ***************************************************************************************************************** */
+#ifndef RING_BUFFER_SHM_H__
+#define RING_BUFFER_SHM_H__
+/* ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                                  Includes section                                                 *
+ * ***************************************************************************************************************** */
+
+/* Standard includes. */
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+/* System includes. */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/* Ring buffer module. */
+#include "RingBuffer.h"
+
+/* ***************************************************************************************************************** *
+ *                                             Global definitions section                                            *
+ * ***************************************************************************************************************** */
+
+/**
+ * Shared ring buffer magic ("RBSH"), published last once the segment is initialized.
+ */
+#define RING_BUFFER_SHM_MAGIC 0x52425348UL
+
+/**
+ * Shared ring buffer layout version, bumped on any change of \ref RingBuffer_ShmHeader_t.
+ */
+#define RING_BUFFER_SHM_VERSION 1UL
+
+/**
+ * Alignment of the shared head / tail indexes in bytes: fixed rather than \ref RING_BUFFER_CACHE_LINE_SIZE, so that
+ * the layout does not depend on the ring buffer configuration.
+ */
+#define RING_BUFFER_SHM_ALIGN 64
+
+/* ***************************************************************************************************************** *
+ *                                                Global types section                                               *
+ * ***************************************************************************************************************** */
+
+/**
+ * Shared ring buffer header, at offset 0 of the segment (slots follow it).
+ */
+typedef struct
+{
+    _Atomic uint32_t magic;                                    /**< \ref RING_BUFFER_SHM_MAGIC once ready. */
+    uint32_t         version;                                  /**< \ref RING_BUFFER_SHM_VERSION. */
+    uint32_t         headerSize;                               /**< Offset of the first slot in bytes. */
+    uint32_t         typeSize;                                 /**< Size of each element in bytes. */
+    uint32_t         length;                                   /**< Number of slots (one is kept free). */
+    _Alignas (RING_BUFFER_SHM_ALIGN) _Atomic uint32_t head;    /**< Write index in [0, length). */
+    _Alignas (RING_BUFFER_SHM_ALIGN) _Atomic uint32_t tail;    /**< Read index in [0, length). */
+} RingBuffer_ShmHeader_t;
+
+/**
+ * Shared ring buffer handle, local to each process.
+ */
+typedef struct
+{
+    RingBuffer_ShmHeader_t* ptrHeader; /**< Mapped segment. */
+    uint8_t*                ptrBuffer; /**< First slot. */
+    size_t                  size;      /**< Size of the mapping in bytes. */
+    int                     fd;        /**< Segment file descriptor (may be passed to another process). */
+    uint32_t                typeSize;  /**< Validated size of each element in bytes. */
+    uint32_t                length;    /**< Validated number of slots. */
+    uint32_t                headCache; /**< Consumer copy of head. */
+    uint32_t                tailCache; /**< Producer copy of tail. */
+} RingBuffer_Shm_t;
+
+_Static_assert (ATOMIC_INT_LOCK_FREE == 2, "Shared ring buffer indexes must be lock-free across processes");
+
+/* ***************************************************************************************************************** *
+ *                                              Global variables section                                             *
+ * ***************************************************************************************************************** */
+
+/* ***************************************************************************************************************** *
+ *                                              Global functions section                                             *
+ * ***************************************************************************************************************** */
+
+/**
+ * Gets the number of slots between two indexes of a shared ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ * @param     head    Head index.
+ * @param     tail    Tail index.
+ *
+ * @return The number of slots from tail to head.
+ */
+static inline uint32_t
+RingBuffer_ShmDistance (const RingBuffer_Shm_t* ptrRing, uint32_t head, uint32_t tail)
+{
+    return (head >= tail) ? (head - tail) : ((ptrRing->length - tail) + head);
+}
+
+/**
+ * Gets the number of slots between two indexes read from the shared header, which another process may have corrupted.
+ *
+ * @param[in] ptrRing Ring buffer.
+ * @param     head    Head index.
+ * @param     tail    Tail index.
+ *
+ * @return The number of slots from tail to head, or the ring buffer length if an index is out of range.
+ */
+static inline uint32_t
+RingBuffer_ShmCheckedDistance (const RingBuffer_Shm_t* ptrRing, uint32_t head, uint32_t tail)
+{
+    return ((head < ptrRing->length) && (tail < ptrRing->length)) ? RingBuffer_ShmDistance (ptrRing, head, tail) :
+                                                                    ptrRing->length;
+}
+
+/**
+ * Advances an index of a shared ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ * @param     index   Index to advance.
+ * @param     size    Number of slots to advance by.
+ *
+ * @return The advanced index.
+ */
+static inline uint32_t
+RingBuffer_ShmAdvance (const RingBuffer_Shm_t* ptrRing, uint32_t index, uint32_t size)
+{
+    return ((index + size) >= ptrRing->length) ? ((index + size) - ptrRing->length) : (index + size);
+}
+
+/**
+ * Maps a shared ring buffer segment and validates its header.
+ *
+ * @param[out] ptrRing Ring buffer handle.
+ * @param      fd      Segment file descriptor (owned by the handle on success).
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise (e.g. not initialized, version mismatch).
+ */
+static inline int32_t
+RingBuffer_ShmAttachFd (RingBuffer_Shm_t* ptrRing, int fd)
+{
+    int32_t                 res;
+    struct stat             info;
+    RingBuffer_ShmHeader_t* ptrHeader;
+
+    RingBuffer_Assert (ptrRing != NULL);
+
+    res       = RING_BUFFER_ERROR;
+    ptrHeader = MAP_FAILED;
+
+    if ((fd >= 0) && (fstat (fd, &info) == 0) && (info.st_size >= (off_t) sizeof (RingBuffer_ShmHeader_t)))
+    {
+        ptrHeader = mmap (NULL, (size_t) info.st_size, (PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0);
+    }
+    else
+    {
+    }
+
+    if (ptrHeader != MAP_FAILED)
+    {
+        /* Geometry is read once and checked against the segment size: the other process is not trusted. */
+        if ((atomic_load_explicit (&ptrHeader->magic, memory_order_acquire) == RING_BUFFER_SHM_MAGIC) &&
+            (ptrHeader->version == RING_BUFFER_SHM_VERSION) &&
+            (ptrHeader->headerSize == sizeof (RingBuffer_ShmHeader_t)) &&
+            (ptrHeader->typeSize > 0UL) && (ptrHeader->length > 1UL) &&
+            (((uint64_t) ptrHeader->typeSize * ptrHeader->length) <=
+             ((uint64_t) info.st_size - sizeof (RingBuffer_ShmHeader_t))))
+        {
+            ptrRing->ptrHeader = ptrHeader;
+            ptrRing->ptrBuffer = &((uint8_t*) ptrHeader)[sizeof (RingBuffer_ShmHeader_t)];
+            ptrRing->size      = (size_t) info.st_size;
+            ptrRing->fd        = fd;
+            ptrRing->typeSize  = ptrHeader->typeSize;
+            ptrRing->length    = ptrHeader->length;
+            ptrRing->headCache = atomic_load_explicit (&ptrHeader->head, memory_order_acquire);
+            ptrRing->tailCache = atomic_load_explicit (&ptrHeader->tail, memory_order_acquire);
+
+            res = RING_BUFFER_OK;
+        }
+        else
+        {
+            (void) munmap (ptrHeader, (size_t) info.st_size);
+        }
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Creates a shared ring buffer segment, either a named POSIX shared memory object or an anonymous memfd.
+ *
+ * @param[out] ptrRing  Ring buffer handle.
+ * @param[in]  ptrName  POSIX shared memory object name (e.g. "/capture"), NULL for a memfd whose descriptor is then
+ *                      passed to the other process (fork, SCM_RIGHTS).
+ * @param      typeSize Size of each element in bytes.
+ * @param      length   Number of usable slots.
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise (e.g. name already exists).
+ */
+static inline int32_t
+RingBuffer_ShmCreate (RingBuffer_Shm_t* ptrRing, const char* ptrName, uint32_t typeSize, uint32_t length)
+{
+    int32_t                 res;
+    int                     fd;
+    uint64_t                size;
+    RingBuffer_ShmHeader_t* ptrHeader;
+
+    RingBuffer_Assert ((ptrRing != NULL) && (typeSize > 0UL) && (length > 0UL) && (length < UINT32_MAX));
+
+    res  = RING_BUFFER_ERROR;
+    size = sizeof (RingBuffer_ShmHeader_t) + ((uint64_t) typeSize * (length + 1UL));
+
+    if (ptrName != NULL)
+    {
+        fd = shm_open (ptrName, (O_RDWR | O_CREAT | O_EXCL), (S_IRUSR | S_IWUSR));
+    }
+    else
+    {
+        fd = memfd_create ("RingBuffer", 0U);
+    }
+
+    if ((fd >= 0) && (size <= (uint64_t) SIZE_MAX) && (ftruncate (fd, (off_t) size) == 0))
+    {
+        ptrHeader = mmap (NULL, (size_t) size, (PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0);
+
+        if (ptrHeader != MAP_FAILED)
+        {
+            ptrHeader->version    = RING_BUFFER_SHM_VERSION;
+            ptrHeader->headerSize = sizeof (RingBuffer_ShmHeader_t);
+            ptrHeader->typeSize   = typeSize;
+            ptrHeader->length     = length + 1UL;
+
+            atomic_init (&ptrHeader->head, 0U);
+            atomic_init (&ptrHeader->tail, 0U);
+
+            /* Attachers that see the magic see the whole header. */
+            atomic_store_explicit (&ptrHeader->magic, RING_BUFFER_SHM_MAGIC, memory_order_release);
+
+            (void) munmap (ptrHeader, (size_t) size);
+
+            res = RingBuffer_ShmAttachFd (ptrRing, fd);
+        }
+        else
+        {
+        }
+    }
+    else
+    {
+    }
+
+    if ((res != RING_BUFFER_OK) && (fd >= 0))
+    {
+        (void) close (fd);
+
+        if (ptrName != NULL)
+        {
+            (void) shm_unlink (ptrName);
+        }
+        else
+        {
+        }
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Attaches to a shared ring buffer created by another process.
+ *
+ * @param[out] ptrRing Ring buffer handle.
+ * @param[in]  ptrName POSIX shared memory object name.
+ *
+ * @return \ref RING_BUFFER_OK on success, \ref RING_BUFFER_ERROR otherwise (e.g. not created yet).
+ */
+static inline int32_t
+RingBuffer_ShmAttach (RingBuffer_Shm_t* ptrRing, const char* ptrName)
+{
+    int32_t res;
+    int     fd;
+
+    RingBuffer_Assert (ptrName != NULL);
+
+    fd  = shm_open (ptrName, O_RDWR, 0);
+    res = RingBuffer_ShmAttachFd (ptrRing, fd);
+
+    if ((res != RING_BUFFER_OK) && (fd >= 0))
+    {
+        (void) close (fd);
+    }
+    else
+    {
+    }
+
+    return res;
+}
+
+/**
+ * Detaches from a shared ring buffer (the segment lives on until every process detached and its name is unlinked).
+ *
+ * @param[in, out] ptrRing Ring buffer handle.
+ */
+static inline void
+RingBuffer_ShmDetach (RingBuffer_Shm_t* ptrRing)
+{
+    RingBuffer_Assert (ptrRing != NULL);
+
+    (void) munmap (ptrRing->ptrHeader, ptrRing->size);
+    (void) close (ptrRing->fd);
+
+    ptrRing->ptrHeader = NULL;
+    ptrRing->ptrBuffer = NULL;
+    ptrRing->fd        = -1;
+}
+
+/**
+ * Removes the name of a POSIX shared memory ring buffer.
+ *
+ * @param[in] ptrName POSIX shared memory object name.
+ */
+static inline void
+RingBuffer_ShmUnlink (const char* ptrName)
+{
+    (void) shm_unlink (ptrName);
+}
+
+/**
+ * Gets the number of usable slots of a shared ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The usable slots number of the ring buffer.
+ */
+static inline uint32_t
+RingBuffer_ShmGetCapacity (const RingBuffer_Shm_t* ptrRing)
+{
+    return ptrRing->length - 1UL;
+}
+
+/**
+ * Gets the number of used slots of a shared ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The number of slots currently used.
+ */
+static inline uint32_t
+RingBuffer_ShmGetUsed (const RingBuffer_Shm_t* ptrRing)
+{
+    uint32_t used;
+
+    used = RingBuffer_ShmCheckedDistance (ptrRing,
+                                          atomic_load_explicit (&ptrRing->ptrHeader->head, memory_order_acquire),
+                                          atomic_load_explicit (&ptrRing->ptrHeader->tail, memory_order_acquire));
+
+    /* Indexes come from another process: never report more than the capacity. */
+    return (used < ptrRing->length) ? used : RingBuffer_ShmGetCapacity (ptrRing);
+}
+
+/**
+ * Gets the number of free slots of a shared ring buffer.
+ *
+ * @param[in] ptrRing Ring buffer.
+ *
+ * @return The number of slots currently available.
+ */
+static inline uint32_t
+RingBuffer_ShmGetFree (const RingBuffer_Shm_t* ptrRing)
+{
+    return RingBuffer_ShmGetCapacity (ptrRing) - RingBuffer_ShmGetUsed (ptrRing);
+}
+
+/**
+ * Pushes up to size items into a shared ring buffer (producer process), wrapping w/ at most two memcpy.
+ *
+ * @note Full ring buffer is never overwritten: the tail is owned by the consumer process.
+ *
+ * @param[in, out] ptrRing   Ring buffer to push to.
+ * @param[in]      ptrSource Linear buffer to copy data from.
+ * @param          size      Number of items to push.
+ *
+ * @return The number of items actually pushed.
+ */
+static inline uint32_t
+RingBuffer_ShmPushBulk (RingBuffer_Shm_t* ptrRing, const void* ptrSource, uint32_t size)
+{
+    uint32_t head;
+    uint32_t used;
+    uint32_t available;
+    uint32_t first;
+
+    head = atomic_load_explicit (&ptrRing->ptrHeader->head, memory_order_relaxed);
+    used = RingBuffer_ShmCheckedDistance (ptrRing, head, ptrRing->tailCache);
+
+    if ((used >= ptrRing->length) || ((RingBuffer_ShmGetCapacity (ptrRing) - used) < size))
+    {
+        ptrRing->tailCache = atomic_load_explicit (&ptrRing->ptrHeader->tail, memory_order_acquire);
+        used               = RingBuffer_ShmCheckedDistance (ptrRing, head, ptrRing->tailCache);
+    }
+    else
+    {
+    }
+
+    /* Indexes come from another process: push nothing if either is out of range. */
+    available = (used < ptrRing->length) ? (RingBuffer_ShmGetCapacity (ptrRing) - used) : 0U;
+
+    if (size < available)
+    {
+        available = size;
+    }
+    else
+    {
+    }
+
+    if (available != 0U)
+    {
+        first = ((ptrRing->length - head) < available) ? (ptrRing->length - head) : available;
+
+        (void) memcpy (&ptrRing->ptrBuffer[(size_t) head * ptrRing->typeSize], ptrSource,
+                       ((size_t) first * ptrRing->typeSize));
+        (void) memcpy (ptrRing->ptrBuffer, &((const uint8_t*) ptrSource)[(size_t) first * ptrRing->typeSize],
+                       ((size_t) (available - first) * ptrRing->typeSize));
+
+        atomic_store_explicit (&ptrRing->ptrHeader->head, RingBuffer_ShmAdvance (ptrRing, head, available),
+                               memory_order_release);
+    }
+    else
+    {
+    }
+
+    return available;
+}
+
+/**
+ * Pops up to size items from a shared ring buffer (consumer process), wrapping w/ at most two memcpy.
+ *
+ * @param[in, out] ptrRing Ring buffer to pop from.
+ * @param[out]     ptrDest Linear buffer to copy data to.
+ * @param          size    Number of items to pop.
+ *
+ * @return The number of items actually popped.
+ */
+static inline uint32_t
+RingBuffer_ShmPopBulk (RingBuffer_Shm_t* ptrRing, void* ptrDest, uint32_t size)
+{
+    uint32_t tail;
+    uint32_t used;
+    uint32_t first;
+
+    tail = atomic_load_explicit (&ptrRing->ptrHeader->tail, memory_order_relaxed);
+    used = RingBuffer_ShmCheckedDistance (ptrRing, ptrRing->headCache, tail);
+
+    if ((used >= ptrRing->length) || (used < size))
+    {
+        ptrRing->headCache = atomic_load_explicit (&ptrRing->ptrHeader->head, memory_order_acquire);
+        used               = RingBuffer_ShmCheckedDistance (ptrRing, ptrRing->headCache, tail);
+    }
+    else
+    {
+    }
+
+    /* Indexes come from another process: pop nothing if either is out of range. */
+    if ((used >= ptrRing->length) || (size < used))
+    {
+        used = (used < ptrRing->length) ? size : 0U;
+    }
+    else
+    {
+    }
+
+    if (used != 0U)
+    {
+        first = ((ptrRing->length - tail) < used) ? (ptrRing->length - tail) : used;
+
+        (void) memcpy (ptrDest, &ptrRing->ptrBuffer[(size_t) tail * ptrRing->typeSize],
+                       ((size_t) first * ptrRing->typeSize));
+        (void) memcpy (&((uint8_t*) ptrDest)[(size_t) first * ptrRing->typeSize], ptrRing->ptrBuffer,
+                       ((size_t) (used - first) * ptrRing->typeSize));
+
+        atomic_store_explicit (&ptrRing->ptrHeader->tail, RingBuffer_ShmAdvance (ptrRing, tail, used),
+                               memory_order_release);
+    }
+    else
+    {
+    }
+
+    return used;
+}
+
+/**
+ * Pushes single item into a shared ring buffer (producer process).
+ *
+ * @param[in, out] ptrRing Ring buffer to push to.
+ * @param[in]      ptrItem Item to push.
+ *
+ * @return \ref RING_BUFFER_OK if pushed, \ref RING_BUFFER_FULL if ring buffer is full.
+ */
+static inline int32_t
+RingBuffer_ShmPush (RingBuffer_Shm_t* ptrRing, const void* ptrItem)
+{
+    return (RingBuffer_ShmPushBulk (ptrRing, ptrItem, 1U) == 1U) ? RING_BUFFER_OK : RING_BUFFER_FULL;
+}
+
+/**
+ * Pops single item from a shared ring buffer (consumer process).
+ *
+ * @param[in, out] ptrRing Ring buffer to pop from.
+ * @param[out]     ptrItem Item to copy the popped item to.
+ *
+ * @return \ref RING_BUFFER_OK if popped, \ref RING_BUFFER_EMPTY if ring buffer is empty.
+ */
+static inline int32_t
+RingBuffer_ShmPop (RingBuffer_Shm_t* ptrRing, void* ptrItem)
+{
+    return (RingBuffer_ShmPopBulk (ptrRing, ptrItem, 1U) == 1U) ? RING_BUFFER_OK : RING_BUFFER_EMPTY;
+}
+
+#endif /* RING_BUFFER_SHM_H__ */
@@ -28,6 +28,80 @@
  */
 #define RING_BUFFER_PROTECT 1
 
+/**
+ * Enable lock-free single-producer/single-consumer operations (C11 atomics, mutually exclusive with
+ * \ref RING_BUFFER_PROTECT).
+ */
+#define RING_BUFFER_SPSC 0
+
+/**
+ * Enable power-of-two lengths w/ free-running indexes (no branch on index update, all slots usable).
+ */
+#define RING_BUFFER_POW2 0
+
+/**
+ * Enable cache-line aligned head / tail (and cached opposite index if \ref RING_BUFFER_SPSC is enabled).
+ */
+#define RING_BUFFER_CACHE_ALIGN 0
+
+/**
+ * Cache line size in bytes (if \ref RING_BUFFER_CACHE_ALIGN is enabled).
+ */
+#define RING_BUFFER_CACHE_LINE_SIZE 64
+
+/**
+ * Enable blocking push / pop with futex wait (Linux only, requires _GNU_SOURCE or -std=gnu11 for syscall).
+ */
+#define RING_BUFFER_WAIT 0
+
+/**
+ * Number of busy-wait iterations before a blocked caller parks (if \ref RING_BUFFER_WAIT is enabled).
+ */
+#define RING_BUFFER_WAIT_SPIN 128
+
+/**
+ * Enable the eventfd readiness notifier, signaled once on the empty -> non-empty transition (Linux only).
+ */
+#define RING_BUFFER_NOTIFY 0
+
+/**
+ * Enable statistics block: pushed / popped / overwritten / dropped items, high-water mark and lock hold time.
+ */
+#define RING_BUFFER_STATS 0
+
+/**
+ * Define RingBuffer_Desc.h functions as static inline in every translation unit (otherwise exactly one translation
+ * unit must define RING_BUFFER_DESC_IMPLEMENTATION before including RingBuffer_Desc.h).
+ */
+#define RING_BUFFER_DESC_INLINE 1
+
+/**
+ * Enable RingBuffer_DescMap: storage mapped w/ transparent / explicit huge pages, NUMA node binding and prefault
+ * (Linux only).
+ */
+#define RING_BUFFER_DESC_MAP 0
+
+/**
+ * Huge page size in bytes (if \ref RING_BUFFER_DESC_MAP is enabled, e.g. 2 MiB on x86-64).
+ */
+#define RING_BUFFER_DESC_HUGE_PAGE_SIZE 2097152UL
+
+/**
+ * Alignment in bytes of RingBuffer_Record.h records (power of two, at least the 4-byte record header).
+ */
+#define RING_BUFFER_RECORD_ALIGN 4
+
+/**
+ * Enable non-temporal (cache bypassing) copy kernels for bulk operations, selected at runtime by CPU features (x86
+ * SSE2 / AVX2 / AVX-512, memcpy elsewhere).
+ */
+#define RING_BUFFER_COPY_STREAM 0
+
+/**
+ * Minimum bulk copy size in bytes for non-temporal stores (if \ref RING_BUFFER_COPY_STREAM is enabled, at least 256).
+ */
+#define RING_BUFFER_COPY_THRESHOLD 262144
+
 /**********************************************************************************************************************
 *           PUBLIC DEFINES                                                                                            *
 **********************************************************************************************************************/